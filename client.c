@@ -0,0 +1,151 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+
+#include "client.h"
+#include "heartbeat.h"
+#include "multicast.h"
+#include "rpc.h"
+#include "telemetry.h"
+
+#define CLIENT_SLEEP_SLICE_MS 100 // 기다리는 중에도 종료 요청을 확인하는 간격
+
+static volatile sig_atomic_t s_stop = 0;
+static volatile sig_atomic_t s_fd = -1;
+
+/***************************************************************************
+ * connect_timeout(const struct sockaddr_in *addr, int timeout_ms)
+ * 허브가 꺼져 있으면 connect가 오래 막히므로 non-blocking으로 연결 후 poll로 기다림
+ * 연결된 소켓 반환 (blocking으로 되돌림), 실패 시 -1
+ ***************************************************************************/
+static int connect_timeout(const struct sockaddr_in *addr, int timeout_ms) {
+    struct pollfd pfd;
+    int err = 0;
+    socklen_t len = sizeof(err);
+    int fd = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+
+    if (fd < 0) {
+        perror("socket");
+        return -1;
+    }
+    fcntl(fd, F_SETFL, O_NONBLOCK);
+    if (connect(fd, (const struct sockaddr*)addr, sizeof(*addr)) == 0) {
+        fcntl(fd, F_SETFL, 0);
+        return fd;
+    }
+    if (errno != EINPROGRESS) {
+        close(fd);
+        return -1;
+    }
+
+    pfd.fd = fd;
+    pfd.events = POLLOUT;
+    if (poll(&pfd, 1, timeout_ms) != 1 || getsockopt(fd, SOL_SOCKET, SO_ERROR, &err, &len) == -1 || err != 0) {
+        close(fd);
+        return -1;
+    }
+    fcntl(fd, F_SETFL, 0);
+    return fd;
+}
+
+// attempt번째 재시도 전 대기 (0 ~ min(최대값, 기본값 * 2^attempt) 사이 임의 시간)
+static void backoff(int attempt, unsigned int *seed) {
+    long cap = CLIENT_BACKOFF_BASE_MS;
+    long wait_ms;
+
+    while (attempt-- > 0 && cap < CLIENT_BACKOFF_MAX_MS) {
+        cap *= 2;
+    }
+    if (cap > CLIENT_BACKOFF_MAX_MS) {
+        cap = CLIENT_BACKOFF_MAX_MS;
+    }
+    wait_ms = rand_r(seed) % (cap + 1);
+    printf("Reconnect in %ld ms\n", wait_ms);
+
+    while (wait_ms > 0 && !s_stop) {
+        long slice = wait_ms < CLIENT_SLEEP_SLICE_MS ? wait_ms : CLIENT_SLEEP_SLICE_MS;
+        struct timespec ts = { slice / 1000, (slice % 1000) * 1000000L };
+        nanosleep(&ts, NULL);
+        wait_ms -= slice;
+    }
+}
+
+/***************************************************************************
+ * tune_socket(int fd)
+ * 허브가 꺼지면 알 수 있도록 TCP keepalive, TCP_USER_TIMEOUT 설정
+ * 허브는 interval마다 PING을 보내므로 interval * (misses + 1) 동안 아무것도 받지 못하면
+ * 수신 스레드의 recv가 실패하고 다시 연결함
+ ***************************************************************************/
+static void tune_socket(int fd) {
+    int interval_ms, misses;
+    struct timeval timeout;
+
+    heartbeat_config(&interval_ms, &misses);
+    heartbeat_tune_socket(fd, interval_ms, misses);
+    timeout.tv_sec = interval_ms * (misses + 1) / 1000;
+    timeout.tv_usec = interval_ms * (misses + 1) % 1000 * 1000;
+    setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+}
+
+int client_run(ProtoConn *conn, const struct sockaddr_in *addr, int role, int topics,
+               CommandTable *commands, ClientSession on_session, void *arg) {
+    unsigned int seed = time(NULL) ^ getpid();
+    int attempt = 0;
+
+    while (!s_stop) {
+        int fd = connect_timeout(addr, CLIENT_CONNECT_TIMEOUT_MS);
+        if (fd == -1) {
+            backoff(attempt++, &seed);
+            continue;
+        }
+        proto_conn_reset(conn, fd);
+        tune_socket(fd);
+
+        // 허브가 새로 시작했을 수 있으므로 연결할 때마다 자기 소개와 구독을 다시 보냄
+        if (proto_send_hello(conn, role) == -1 ||
+            (topics != 0 && telemetry_subscribe(conn, mcast_topics(topics)) == -1) ||
+            rpc_start(conn, commands) == -1) {
+            proto_conn_reset(conn, -1);
+            close(fd);
+            backoff(attempt++, &seed);
+            continue;
+        }
+        s_fd = fd;
+        if (s_stop) {
+            shutdown(fd, SHUT_RDWR); // 연결하는 동안 종료 요청이 온 경우
+        }
+        printf("Socket Connection Complete!\n");
+        attempt = 0;
+
+        if (on_session) {
+            on_session(arg);
+        }
+        rpc_join();
+
+        // 다른 스레드가 닫힌 소켓 번호로 보내지 않도록 먼저 끊김 표시
+        s_fd = -1;
+        proto_conn_reset(conn, -1);
+        close(fd);
+        if (!s_stop) {
+            printf("Connection lost\n");
+            backoff(attempt++, &seed);
+        }
+    }
+    return 0;
+}
+
+void client_stop(void) {
+    int fd = s_fd;
+
+    s_stop = 1;
+    if (fd >= 0) {
+        shutdown(fd, SHUT_RDWR); // 수신 스레드를 깨움
+    }
+}
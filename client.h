@@ -0,0 +1,31 @@
+#ifndef CLIENT_H
+#define CLIENT_H
+
+#include <netinet/in.h>
+
+#include "proto.h"
+#include "command.h"
+
+#define CLIENT_CONNECT_TIMEOUT_MS 3000  // 연결 요청 한 번의 최대 대기 시간
+#define CLIENT_BACKOFF_BASE_MS 250      // 첫 번째 재시도 대기 시간 상한
+#define CLIENT_BACKOFF_MAX_MS 30000     // 재시도 대기 시간 상한의 최대값
+
+// 허브와 연결될 때마다 (HELLO, 구독 후) 호출되는 함수, 수신 스레드가 동작 중이므로 rpc_call 사용 가능
+typedef void (*ClientSession)(void *arg);
+
+/***************************************************************************
+ * client_run(ProtoConn *conn, const struct sockaddr_in *addr, int role, int topics,
+ *            CommandTable *commands, ClientSession on_session, void *arg)
+ * 허브 연결 관리, client_stop이 호출될 때까지 반환하지 않음
+ * 연결 -> HELLO -> 구독(topics, multicast로 받는 중이면 TOPIC_MULTICAST 추가) -> 수신 스레드 시작 -> on_session
+ * 연결이 끊어지거나 허브가 아직 없으면 지수적으로 늘어나는 임의 시간만큼 기다렸다가 처음부터 다시
+ * (여러 노드가 한꺼번에 다시 연결하지 않도록 0 ~ 상한 사이에서 고름)
+ * 연결이 끊긴 동안 conn으로 보내는 메시지는 ENOTCONN으로 실패함
+ ***************************************************************************/
+int client_run(ProtoConn *conn, const struct sockaddr_in *addr, int role, int topics,
+               CommandTable *commands, ClientSession on_session, void *arg);
+
+// client_run 종료 요청 (시그널 처리 함수에서 호출 가능)
+void client_stop(void);
+
+#endif
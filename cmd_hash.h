@@ -0,0 +1,26 @@
+// cmd_hash_gen 으로 생성한 파일, 직접 수정하지 말 것 (cmd_list.h 를 고친 뒤 다시 생성)
+#ifndef CMD_HASH_H
+#define CMD_HASH_H
+
+#include "cmd_list.h"
+
+#define CMD_HASH_SEED 0u
+#define CMD_HASH_SIZE 32
+
+static const CmdHashEntry cmd_hash_table[CMD_HASH_SIZE] = {
+    [2] = { "WATER LOW", 9, PROTO_WATER_LOW },
+    [4] = { "HUMID", 5, PROTO_HUMID },
+    [7] = { "TEMP", 4, PROTO_TEMP },
+    [8] = { "Grow OK", 7, PROTO_GROW_OK },
+    [12] = { "LIGHT_START", 11, PROTO_LIGHT_START },
+    [16] = { "WATER", 5, PROTO_WATER },
+    [18] = { "WATER OK", 8, PROTO_WATER_OK },
+    [21] = { "LIGHT_END", 9, PROTO_LIGHT_END },
+    [22] = { "PlantDate", 9, PROTO_PLANT_DATE },
+    [23] = { "LED ON", 6, PROTO_LED_ON },
+    [25] = { "PlantName", 9, PROTO_PLANT_NAME },
+    [27] = { "LED OFF", 7, PROTO_LED_OFF },
+    [31] = { "PLANT UPDATE", 12, PROTO_PLANT_UPDATE },
+};
+
+#endif
@@ -0,0 +1,73 @@
+#include <stdio.h>
+#include <string.h>
+
+#include "cmd_list.h"
+
+/***************************************************************************
+ * cmd_hash_gen
+ * cmd_list.h의 기존 문자열 명령으로 충돌 없는 해시 테이블(perfect hash)을 찾아
+ * cmd_hash.h를 출력하는 생성기
+ * 사용법 : gcc -o cmd_hash_gen cmd_hash_gen.c && ./cmd_hash_gen > cmd_hash.h.tmp && mv cmd_hash.h.tmp cmd_hash.h
+ * (바로 cmd_hash.h로 출력하면 셸이 먼저 파일을 비우므로 임시 파일에 씀)
+ ***************************************************************************/
+#define CMD_HASH_SIZE 32       // 2의 거듭제곱, 명령 수보다 커야 함
+#define CMD_SEED_TRIES 1000000
+
+typedef struct {
+    const char *text;
+    const char *opcode_name;
+} Command;
+
+#define CMD_ENTRY(op, text, roles) { text, #op },
+static const Command s_commands[] = { CMD_LIST(CMD_ENTRY) };
+#define COMMAND_COUNT (int)(sizeof(s_commands) / sizeof(s_commands[0]))
+
+// seed로 모든 명령이 서로 다른 칸에 들어가면 slot에 칸 번호를 채우고 1 반환
+static int try_seed(unsigned int seed, int slot[]) {
+    int used[CMD_HASH_SIZE] = {0};
+
+    for (int i = 0; i < COMMAND_COUNT; i++) {
+        const char *text = s_commands[i].text;
+        if (text == NULL) {
+            continue;
+        }
+        int pos = cmd_hash((const unsigned char*)text, strlen(text), seed) & (CMD_HASH_SIZE - 1);
+        if (used[pos]) {
+            return 0;
+        }
+        used[pos] = 1;
+        slot[i] = pos;
+    }
+    return 1;
+}
+
+int main(void) {
+    int slot[COMMAND_COUNT];
+    unsigned int seed;
+
+    for (seed = 0; seed < CMD_SEED_TRIES; seed++) {
+        if (try_seed(seed, slot)) {
+            break;
+        }
+    }
+    if (seed == CMD_SEED_TRIES) {
+        fprintf(stderr, "no perfect hash seed found, increase CMD_HASH_SIZE\n");
+        return 1;
+    }
+
+    printf("// cmd_hash_gen 으로 생성한 파일, 직접 수정하지 말 것 (cmd_list.h 를 고친 뒤 다시 생성)\n");
+    printf("#ifndef CMD_HASH_H\n#define CMD_HASH_H\n\n#include \"cmd_list.h\"\n\n");
+    printf("#define CMD_HASH_SEED %uu\n", seed);
+    printf("#define CMD_HASH_SIZE %d\n\n", CMD_HASH_SIZE);
+    printf("static const CmdHashEntry cmd_hash_table[CMD_HASH_SIZE] = {\n");
+    for (int pos = 0; pos < CMD_HASH_SIZE; pos++) {
+        for (int i = 0; i < COMMAND_COUNT; i++) {
+            if (s_commands[i].text != NULL && slot[i] == pos) {
+                printf("    [%d] = { \"%s\", %d, %s },\n", pos, s_commands[i].text,
+                       (int)strlen(s_commands[i].text), s_commands[i].opcode_name);
+            }
+        }
+    }
+    printf("};\n\n#endif\n");
+    return 0;
+}
@@ -0,0 +1,49 @@
+#ifndef CMD_LIST_H
+#define CMD_LIST_H
+
+#include "proto.h"
+
+/***************************************************************************
+ * 명령 목록
+ * CMD(opcode, 기존 문자열 명령, 받는 노드 역할)
+ * 기존 문자열이 NULL인 항목은 opcode로만 주고받음
+ * 문자열을 추가하거나 바꾸면 cmd_hash_gen으로 cmd_hash.h를 다시 생성해야 함
+ ***************************************************************************/
+#define CMD_LIST(CMD) \
+    CMD(PROTO_REPLY,        NULL,           ROLE_DISPLAY | ROLE_ACTUATOR) \
+    CMD(PROTO_SUBSCRIBE,    NULL,           ROLE_HUB) \
+    CMD(PROTO_SNAPSHOT,     NULL,           ROLE_DISPLAY | ROLE_ACTUATOR) \
+    CMD(PROTO_PING,         NULL,           ROLE_DISPLAY | ROLE_ACTUATOR) \
+    CMD(PROTO_PONG,         NULL,           ROLE_HUB) \
+    CMD(PROTO_LED_ON,       "LED ON",       ROLE_HUB) \
+    CMD(PROTO_LED_OFF,      "LED OFF",      ROLE_HUB) \
+    CMD(PROTO_WATER_LOW,    "WATER LOW",    ROLE_HUB | ROLE_DISPLAY) \
+    CMD(PROTO_WATER_OK,     "WATER OK",     ROLE_HUB | ROLE_DISPLAY) \
+    CMD(PROTO_GROW_OK,      "Grow OK",      ROLE_DISPLAY) \
+    CMD(PROTO_TEMP,         "TEMP",         ROLE_HUB) \
+    CMD(PROTO_HUMID,        "HUMID",        ROLE_HUB) \
+    CMD(PROTO_PLANT_NAME,   "PlantName",    ROLE_HUB) \
+    CMD(PROTO_PLANT_DATE,   "PlantDate",    ROLE_HUB) \
+    CMD(PROTO_PLANT_UPDATE, "PLANT UPDATE", ROLE_HUB) \
+    CMD(PROTO_WATER,        "WATER",        ROLE_ACTUATOR) \
+    CMD(PROTO_LIGHT_START,  "LIGHT_START",  ROLE_ACTUATOR) \
+    CMD(PROTO_LIGHT_END,    "LIGHT_END",    ROLE_ACTUATOR)
+
+// 기존 문자열 명령 해시 (FNV-1a, seed로 충돌 없는 값을 찾음)
+static inline unsigned int cmd_hash(const unsigned char *text, int len, unsigned int seed) {
+    unsigned int h = 2166136261u ^ seed;
+
+    for (int i = 0; i < len; i++) {
+        h = (h ^ text[i]) * 16777619u;
+    }
+    return h;
+}
+
+// 해시 테이블 항목
+typedef struct {
+    const char *text;
+    int length;
+    int opcode;
+} CmdHashEntry;
+
+#endif
@@ -0,0 +1,68 @@
+#include <stdio.h>
+#include <string.h>
+
+#include "command.h"
+#include "cmd_hash.h"
+
+// opcode마다 받을 수 있는 노드 역할과 이름
+#define CMD_ROLES(op, text, roles) [op] = roles,
+#define CMD_NAME(op, text, roles) [op] = #op,
+static const int s_roles[PROTO_TYPE_MAX] = { CMD_LIST(CMD_ROLES) };
+static const char *s_names[PROTO_TYPE_MAX] = { CMD_LIST(CMD_NAME) };
+
+void command_init(CommandTable *table, int role) {
+    memset(table, 0, sizeof(CommandTable));
+    table->role = role;
+}
+
+int command_register(CommandTable *table, int opcode, CommandHandler handler, void *arg) {
+    if (opcode <= 0 || opcode >= PROTO_TYPE_MAX || !(s_roles[opcode] & table->role)) {
+        fprintf(stderr, "command %s is not for role %d\n", command_name(opcode), table->role);
+        return -1;
+    }
+    table->handlers[opcode] = handler;
+    table->args[opcode] = arg;
+    return 0;
+}
+
+int command_lookup(const unsigned char *text, int len) {
+    const CmdHashEntry *entry = &cmd_hash_table[cmd_hash(text, len, CMD_HASH_SEED) & (CMD_HASH_SIZE - 1)];
+
+    // 같은 칸에 들어가는 다른 문자열일 수 있으므로 한 번은 비교
+    if (entry->text == NULL || entry->length != len || memcmp(entry->text, text, len) != 0) {
+        return -1;
+    }
+    return entry->opcode;
+}
+
+int command_dispatch(CommandTable *table, ProtoConn *conn, const ProtoMsg *msg) {
+    ProtoMsg legacy;
+    int opcode = msg->type;
+
+    if (opcode == PROTO_TEXT) {
+        opcode = command_lookup(msg->payload, msg->length);
+        if (opcode == -1) {
+            table->unknown++;
+            return -1;
+        }
+        // 문자열 명령은 payload 없는 opcode 명령과 같음
+        legacy = *msg;
+        legacy.type = opcode;
+        legacy.length = 0;
+        msg = &legacy;
+    }
+
+    if (opcode <= 0 || opcode >= PROTO_TYPE_MAX || table->handlers[opcode] == NULL) {
+        table->unknown++;
+        return -1;
+    }
+    table->handlers[opcode](conn, msg, table->args[opcode]);
+    return 0;
+}
+
+const char *command_name(int opcode) {
+    if (opcode <= 0 || opcode >= PROTO_TYPE_MAX || s_names[opcode] == NULL) {
+        return "UNKNOWN";
+    }
+    return s_names[opcode];
+}
@@ -0,0 +1,41 @@
+#ifndef COMMAND_H
+#define COMMAND_H
+
+#include "proto.h"
+
+// 명령 처리 함수 (msg의 payload는 함수가 반환할 때까지만 유효)
+typedef void (*CommandHandler)(ProtoConn *conn, const ProtoMsg *msg, void *arg);
+
+/***************************************************************************
+ * 명령 테이블
+ * opcode로 바로 처리 함수를 찾으므로 명령 수와 관계없이 메시지마다 비용이 같음
+ * 노드 역할마다 받을 수 있는 명령만 등록할 수 있음 (cmd_list.h)
+ ***************************************************************************/
+typedef struct {
+    int role;
+    CommandHandler handlers[PROTO_TYPE_MAX];
+    void *args[PROTO_TYPE_MAX];
+    long unknown;  // 처리 함수가 없는 메시지 수
+} CommandTable;
+
+// 역할(ROLE_HUB 등)에 맞는 빈 명령 테이블 초기화
+void command_init(CommandTable *table, int role);
+
+// 처리 함수 등록 (이 역할이 받지 않는 명령이면 -1)
+int command_register(CommandTable *table, int opcode, CommandHandler handler, void *arg);
+
+/***************************************************************************
+ * command_dispatch(CommandTable *table, ProtoConn *conn, const ProtoMsg *msg)
+ * 메시지를 opcode에 등록된 처리 함수로 전달함
+ * 이전 버전 노드가 보낸 문자열 명령(PROTO_TEXT)은 command_lookup으로 opcode로 바꿔서 전달
+ * 0 = 처리함, -1 = 처리 함수 없음
+ ***************************************************************************/
+int command_dispatch(CommandTable *table, ProtoConn *conn, const ProtoMsg *msg);
+
+// 기존 문자열 명령의 opcode (생성된 perfect hash 사용, 없는 명령이면 -1)
+int command_lookup(const unsigned char *text, int len);
+
+// opcode 이름 (로그 출력용)
+const char *command_name(int opcode);
+
+#endif
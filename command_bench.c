@@ -0,0 +1,168 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <arpa/inet.h>
+
+#include "proto.h"
+#include "command.h"
+
+// 벤치마크 설정
+#define BENCH_MESSAGES 5000000
+#define BENCH_STREAM_MESSAGES 4096 // 미리 만들어 둔 메시지 수 (반복해서 사용)
+#define BENCH_CHUNK 1460           // recv 한 번에 들어오는 바이트 수 (이더넷 MSS)
+
+// 허브가 받는 명령 (기존 rpi2의 if/else 순서)
+static const struct {
+    const char *text;
+    int opcode;
+} s_hub_commands[] = {
+    {"LED ON", PROTO_LED_ON},
+    {"LED OFF", PROTO_LED_OFF},
+    {"WATER LOW", PROTO_WATER_LOW},
+    {"WATER OK", PROTO_WATER_OK},
+    {"TEMP", PROTO_TEMP},
+    {"HUMID", PROTO_HUMID},
+    {"PlantName", PROTO_PLANT_NAME},
+    {"PlantDate", PROTO_PLANT_DATE},
+    {"PLANT UPDATE", PROTO_PLANT_UPDATE},
+};
+#define HUB_COMMAND_COUNT (int)(sizeof(s_hub_commands) / sizeof(s_hub_commands[0]))
+
+static unsigned char s_stream[BENCH_STREAM_MESSAGES * (PROTO_HEADER_LEN + 16)];
+static int s_stream_len;
+static long s_handled[PROTO_TYPE_MAX];
+
+// 메시지 하나를 스트림 끝에 추가
+static void stream_add(int type, const char *text, unsigned int seq) {
+    unsigned short type16 = htons(type);
+    unsigned short length16 = htons(text ? strlen(text) : 0);
+    unsigned int seq32 = htonl(seq);
+    unsigned char *p = s_stream + s_stream_len;
+
+    memcpy(p, &type16, 2);
+    memcpy(p + 2, &length16, 2);
+    memcpy(p + 4, &seq32, 4);
+    s_stream_len += PROTO_HEADER_LEN;
+    if (text) {
+        memcpy(p + PROTO_HEADER_LEN, text, strlen(text));
+        s_stream_len += strlen(text);
+    }
+}
+
+// 기존 명령 분포 그대로 스트림 생성 (legacy = 1 이면 문자열 명령)
+static void stream_build(int legacy) {
+    unsigned int seed = 1;
+
+    s_stream_len = 0;
+    for (int i = 0; i < BENCH_STREAM_MESSAGES; i++) {
+        seed = seed * 1103515245 + 12345;
+        int k = (seed >> 16) % HUB_COMMAND_COUNT;
+        if (legacy) {
+            stream_add(PROTO_TEXT, s_hub_commands[k].text, i);
+        } else {
+            stream_add(s_hub_commands[k].opcode, NULL, i);
+        }
+    }
+}
+
+// 소켓 대신 수신 버퍼에 직접 채움 (시스템 콜 비용을 빼고 해석/분배만 측정)
+static int bench_fill(ProtoConn *conn, int *offset) {
+    unsigned int space = PROTO_RING_SIZE - (conn->tail - conn->head);
+    int len = BENCH_CHUNK;
+
+    if (len > (int)space) {
+        len = space;
+    }
+    if (len > s_stream_len - *offset) {
+        len = s_stream_len - *offset;
+    }
+    unsigned int pos = conn->tail & (PROTO_RING_SIZE - 1);
+    int first = len < (int)(PROTO_RING_SIZE - pos) ? len : (int)(PROTO_RING_SIZE - pos);
+    memcpy(conn->ring + pos, s_stream + *offset, first);
+    memcpy(conn->ring, s_stream + *offset + first, len - first);
+    conn->tail += len;
+    *offset += len;
+    if (*offset == s_stream_len) {
+        *offset = 0; // 스트림을 처음부터 다시 사용
+    }
+    return len;
+}
+
+static void on_command(ProtoConn *conn, const ProtoMsg *msg, void *arg) {
+    s_handled[msg->type]++;
+}
+
+/***************************************************************************
+ * legacy_dispatch(const ProtoMsg *msg)
+ * 기존 rpi2 방식 : NUL로 끝나는 문자열로 만든 뒤 strcmp if/else 순서대로 비교
+ ***************************************************************************/
+static void legacy_dispatch(const ProtoMsg *msg) {
+    char buffer[PROTO_PAYLOAD_MAX + 1];
+
+    proto_text(msg, buffer, sizeof(buffer));
+    for (int i = 0; i < HUB_COMMAND_COUNT; i++) {
+        if (strcmp(buffer, s_hub_commands[i].text) == 0) {
+            s_handled[s_hub_commands[i].opcode]++;
+            return;
+        }
+    }
+}
+
+// 현재 시간을 초 단위로 반환
+static double now_sec(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+// mode 0 = 문자열 + strcmp, 1 = 문자열 + perfect hash, 2 = opcode
+static void run(const char *name, int mode, CommandTable *table) {
+    static ProtoConn conn;
+    ProtoMsg msg;
+    long count = 0;
+    int offset = 0;
+    double start;
+
+    stream_build(mode != 2);
+    proto_conn_init(&conn, -1);
+    memset(s_handled, 0, sizeof(s_handled));
+
+    start = now_sec();
+    while (count < BENCH_MESSAGES) {
+        bench_fill(&conn, &offset);
+        while (proto_next(&conn, &msg) == 1) {
+            if (mode == 0) {
+                legacy_dispatch(&msg);
+            } else {
+                command_dispatch(table, &conn, &msg);
+            }
+            count++;
+            if (msg.seq == BENCH_STREAM_MESSAGES - 1) {
+                conn.rx_seq = 0; // 다시 사용하는 스트림의 seq는 0부터
+            }
+        }
+    }
+    double elapsed = now_sec() - start;
+
+    long handled = 0;
+    for (int i = 0; i < PROTO_TYPE_MAX; i++) {
+        handled += s_handled[i];
+    }
+    printf("%-22s: %6.2f M msgs/sec, %6.1f ns/msg, handled %ld/%ld\n",
+           name, count / elapsed / 1e6, elapsed * 1e9 / count, handled, count);
+}
+
+int main(void) {
+    CommandTable table;
+
+    command_init(&table, ROLE_HUB);
+    for (int i = 0; i < HUB_COMMAND_COUNT; i++) {
+        command_register(&table, s_hub_commands[i].opcode, on_command, NULL);
+    }
+
+    run("text + strcmp chain", 0, &table);
+    run("text + perfect hash", 1, &table);
+    run("opcode table", 2, &table);
+    return 0;
+}
@@ -0,0 +1,263 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <string.h>
+#include <errno.h>
+#include <stdint.h>
+#include <sys/timerfd.h>
+
+#include "hal.h"
+#include "dht.h"
+
+// DHT 타이밍
+#define DHT11_START_US 20000     // 시작 신호 LOW 폭 (DHT11 최소 18ms)
+#define DHT22_START_US 1100      // 시작 신호 LOW 폭 (DHT22 최소 1ms)
+#define DHT_BITS 40
+#define DHT_PULSE_MIN_US 8       // 이보다 짧은 펄스는 잡음
+#define DHT_PULSE_MAX_US 120     // 비트 펄스의 최대 폭 (규격 80us + 여유)
+#define DHT_CLASSIFY_ROUNDS 3    // 기준값 재계산 횟수
+#define DHT_RESPONSE_TIMEOUT_MS 5 // 시작 신호 후 첫 edge까지 기다릴 시간
+#define DHT_EDGE_TIMEOUT_MS 2    // 이 시간 동안 edge가 없으면 응답이 끝난 것으로 판단
+
+// 측정 간격
+#define DHT_WARMUP_MS 1000       // 시작 후 첫 측정까지 (전원 안정화)
+#define DHT_INTERVAL_MS 2000     // 정상 측정 간격
+#define DHT11_MIN_INTERVAL_MS 1000 // 센서가 다시 응답할 수 있는 최소 간격
+#define DHT22_MIN_INTERVAL_MS 2000
+
+DhtResult dht_decode(const HalEdge *edges, int count, DhtType type) {
+    DhtResult result;
+    long low_us[DHT_MAX_EDGES];
+    long high_us[DHT_MAX_EDGES];
+    int pulses = 0;
+
+    memset(&result, 0, sizeof(result));
+    result.status = DHT_NO_RESPONSE;
+    if (count <= 0) {
+        return result;
+    }
+
+    // falling -> rising -> falling 마다 LOW 폭과 HIGH 폭 기록
+    // 같은 방향 edge가 연속되면 (edge 누락) 그 펄스는 건너뜀
+    for (int i = 1; i + 1 < count && pulses < DHT_MAX_EDGES; i++) {
+        if (!edges[i].rising || edges[i - 1].rising || edges[i + 1].rising) {
+            continue;
+        }
+        low_us[pulses] = (long)((edges[i].ts_ns - edges[i - 1].ts_ns) / 1000);
+        high_us[pulses] = (long)((edges[i + 1].ts_ns - edges[i].ts_ns) / 1000);
+        pulses++;
+    }
+    if (pulses < DHT_BITS) {
+        result.status = DHT_SHORT_FRAME;
+        return result;
+    }
+
+    // 앞쪽 응답 펄스(80us)를 빼고 마지막 40개가 데이터 비트
+    const long *low = low_us + pulses - DHT_BITS;
+    const long *high = high_us + pulses - DHT_BITS;
+    double threshold = 0;
+    for (int i = 0; i < DHT_BITS; i++) {
+        if (low[i] < DHT_PULSE_MIN_US || low[i] > DHT_PULSE_MAX_US ||
+            high[i] < DHT_PULSE_MIN_US || high[i] > DHT_PULSE_MAX_US) {
+            result.status = DHT_BAD_TIMING;
+            return result;
+        }
+        threshold += low[i];
+    }
+
+    // 첫 기준값은 LOW 폭 평균 (0 = 26~28us, 1 = 70us, LOW = 50us)
+    // 이후 두 무리(0, 1) 평균의 중간값으로 기준을 다시 잡음
+    threshold /= DHT_BITS;
+    for (int round = 0; round < DHT_CLASSIFY_ROUNDS; round++) {
+        double sum0 = 0, sum1 = 0;
+        int n0 = 0, n1 = 0;
+        for (int i = 0; i < DHT_BITS; i++) {
+            if (high[i] > threshold) {
+                sum1 += high[i];
+                n1++;
+            } else {
+                sum0 += high[i];
+                n0++;
+            }
+        }
+        if (n0 == 0 || n1 == 0) {
+            break; // 모든 비트가 같으면 LOW 기준 유지
+        }
+        threshold = (sum0 / n0 + sum1 / n1) / 2;
+    }
+
+    for (int i = 0; i < DHT_BITS; i++) {
+        result.bytes[i / 8] = (result.bytes[i / 8] << 1) | (high[i] > threshold);
+    }
+    if (((result.bytes[0] + result.bytes[1] + result.bytes[2] + result.bytes[3]) & 0xFF) != result.bytes[4]) {
+        result.status = DHT_CHECKSUM;
+        return result;
+    }
+
+    if (type == DHT22) {
+        // 0.1 단위 16비트 값, 온도 최상위 비트는 부호
+        result.humid = ((result.bytes[0] << 8) | result.bytes[1]) / 10.0f;
+        result.temp = (((result.bytes[2] & 0x7F) << 8) | result.bytes[3]) / 10.0f;
+        if (result.bytes[2] & 0x80) {
+            result.temp = -result.temp;
+        }
+    } else {
+        // 정수부 + 소수부, 온도 소수부 최상위 비트는 부호
+        result.humid = result.bytes[0] + result.bytes[1] / 10.0f;
+        result.temp = result.bytes[2] + (result.bytes[3] & 0x7F) / 10.0f;
+        if (result.bytes[3] & 0x80) {
+            result.temp = -result.temp;
+        }
+    }
+    result.status = DHT_OK;
+    return result;
+}
+
+// 시작 신호를 보내고 응답 edge를 모아서 해석
+static DhtResult dht_transfer(int line, DhtType type) {
+    HalEdge edges[DHT_MAX_EDGES];
+    DhtResult result;
+    int count = 0;
+    int timeout = DHT_RESPONSE_TIMEOUT_MS;
+
+    memset(&result, 0, sizeof(result));
+    result.status = DHT_ERROR;
+
+    // 이전 측정에서 남은 이벤트 비우기
+    while (hal()->gpio_line_read(line, &edges[0], 0) == 1) {
+    }
+
+    if (hal()->gpio_line_pulse(line, type == DHT22 ? DHT22_START_US : DHT11_START_US) == -1) {
+        return result;
+    }
+
+    // 커널이 edge마다 타임스탬프를 찍으므로 읽는 쪽 지연은 결과에 영향 없음
+    while (count < DHT_MAX_EDGES) {
+        int ret = hal()->gpio_line_read(line, &edges[count], timeout);
+        if (ret == -1) {
+            return result;
+        }
+        if (ret == 0) {
+            break;
+        }
+        count++;
+        timeout = DHT_EDGE_TIMEOUT_MS;
+    }
+    return dht_decode(edges, count, type);
+}
+
+/***************************************************************************
+ * DHT 센서 플러그인
+ ***************************************************************************/
+typedef struct {
+    int pin;
+    DhtType type;
+    int line;                    // 라인 이벤트 핸들
+    int timer_fd;                // 다음 측정 시각
+    int failures[DHT_ERROR + 1]; // 원인별 실패 횟수
+} DhtState;
+
+// delay_ms 뒤에 한 번 측정하도록 타이머 설정
+static int dht_arm(DhtState *st, int delay_ms) {
+    struct itimerspec its;
+
+    memset(&its, 0, sizeof(its));
+    its.it_value.tv_sec = delay_ms / 1000;
+    its.it_value.tv_nsec = (delay_ms % 1000) * 1000000L;
+    return timerfd_settime(st->timer_fd, 0, &its, NULL);
+}
+
+static int dht_start(SensorPlugin *p) {
+    DhtState *st = p->priv;
+
+    st->line = hal()->gpio_line_request(st->pin);
+    if (st->line == -1) {
+        return -1;
+    }
+    st->timer_fd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    if (st->timer_fd == -1 || dht_arm(st, DHT_WARMUP_MS) == -1) {
+        perror("Failed to create dht timer");
+        p->stop(p);
+        return -1;
+    }
+    return 0;
+}
+
+static int dht_fd(SensorPlugin *p) {
+    return ((DhtState*)p->priv)->timer_fd;
+}
+
+static int dht_read(SensorPlugin *p, SensorReading *out) {
+    DhtState *st = p->priv;
+    uint64_t expirations;
+
+    if (read(st->timer_fd, &expirations, sizeof(expirations)) != sizeof(expirations)) {
+        return errno == EAGAIN || errno == EINTR ? 0 : -1;
+    }
+
+    DhtResult result = dht_transfer(st->line, st->type);
+    if (result.status == DHT_ERROR) {
+        return -1;
+    }
+    if (result.status != DHT_OK) {
+        // 같은 자리에서 기다리며 재시도하지 않고 최소 간격 뒤에 다시 측정
+        int retry_ms = st->type == DHT22 ? DHT22_MIN_INTERVAL_MS : DHT11_MIN_INTERVAL_MS;
+        st->failures[result.status]++;
+        printf("sensor %s : %s, retry in %d ms (%d times)\n", p->name,
+               dht_status_str(result.status), retry_ms, st->failures[result.status]);
+        dht_arm(st, retry_ms);
+        return 0;
+    }
+
+    out->temp = result.temp;
+    out->humid = result.humid;
+    dht_arm(st, DHT_INTERVAL_MS);
+    return 1;
+}
+
+static void dht_stop(SensorPlugin *p) {
+    DhtState *st = p->priv;
+
+    if (st->timer_fd != -1) {
+        close(st->timer_fd);
+        st->timer_fd = -1;
+    }
+    if (st->line != -1) {
+        hal()->gpio_line_release(st->line);
+        st->line = -1;
+    }
+}
+
+SensorPlugin *dht_plugin_create(int pin, DhtType type) {
+    SensorPlugin *p = calloc(1, sizeof(SensorPlugin));
+    DhtState *st = calloc(1, sizeof(DhtState));
+    if (p == NULL || st == NULL) {
+        free(p);
+        free(st);
+        return NULL;
+    }
+
+    st->pin = pin;
+    st->type = type;
+    st->line = -1;
+    st->timer_fd = -1;
+
+    p->name = type == DHT22 ? "dht22" : "dht11";
+    p->start = dht_start;
+    p->fd = dht_fd;
+    p->read = dht_read;
+    p->stop = dht_stop;
+    p->priv = st;
+    return p;
+}
+
+const char *dht_status_str(DhtStatus status) {
+    switch (status) {
+        case DHT_OK: return "ok";
+        case DHT_NO_RESPONSE: return "no response";
+        case DHT_SHORT_FRAME: return "short frame";
+        case DHT_BAD_TIMING: return "bad timing";
+        case DHT_CHECKSUM: return "checksum mismatch";
+        default: return "error";
+    }
+}
@@ -0,0 +1,53 @@
+#ifndef DHT_H
+#define DHT_H
+
+#include "hal.h"
+#include "sensor.h"
+
+// 센서 종류 (데이터 형식과 최소 측정 간격이 다름)
+typedef enum {
+    DHT11 = 11,
+    DHT22 = 22
+} DhtType;
+
+// 측정 결과 (실패 시 다시 시도해야 하는 원인)
+typedef enum {
+    DHT_OK = 0,
+    DHT_NO_RESPONSE,  // 시작 신호 후 edge가 하나도 없음
+    DHT_SHORT_FRAME,  // 40비트보다 적게 수신 (edge 누락)
+    DHT_BAD_TIMING,   // 펄스 폭이 센서 규격 범위를 벗어남
+    DHT_CHECKSUM,     // 체크섬 불일치
+    DHT_ERROR         // 장치 접근 오류
+} DhtStatus;
+
+typedef struct {
+    float temp;         // 온도 (C, DHT_OK 일 때만 유효)
+    float humid;        // 습도 (%, DHT_OK 일 때만 유효)
+    unsigned char bytes[5];
+    DhtStatus status;
+} DhtResult;
+
+// 응답 한 번에 들어오는 최대 edge 수 (응답 3개 + 비트 80개 + 해제 1개, 여유 포함)
+#define DHT_MAX_EDGES 100
+
+/***************************************************************************
+ * dht_decode(const HalEdge *edges, int count, DhtType type)
+ * 시작 신호 이후 기록된 edge 타임스탬프로 40비트 응답을 복원함
+ * 각 비트의 HIGH 펄스 폭을 같은 응답의 LOW 펄스 폭(약 50us)을 기준으로 나눈 뒤
+ * 두 무리의 평균 사이로 기준값을 다시 잡으므로 센서 클럭 오차와 지터에 강함
+ * 하드웨어에 접근하지 않으므로 기록해 둔 edge 배열로 오프라인 검증 가능
+ ***************************************************************************/
+DhtResult dht_decode(const HalEdge *edges, int count, DhtType type);
+
+/***************************************************************************
+ * dht_plugin_create(int pin, DhtType type)
+ * 핀을 라인 이벤트로 요청하고 timerfd 주기마다 한 번씩 측정하는 센서 플러그인 생성
+ * 측정에 실패하면 원인을 출력하고 센서 최소 간격 뒤에 다시 측정함
+ * 핀은 sysfs로 export 하지 않아야 함
+ ***************************************************************************/
+SensorPlugin *dht_plugin_create(int pin, DhtType type);
+
+// 결과 값을 문자열로 변환
+const char *dht_status_str(DhtStatus status);
+
+#endif
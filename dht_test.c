@@ -0,0 +1,238 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+
+#include "dht.h"
+
+/***************************************************************************
+ * dht_test
+ * 기록해 둔 edge 타임스탬프로 dht_decode 확인 (하드웨어 없이)
+ *  - 깨끗한 응답 (DHT11, DHT22 음수 온도)
+ *  - 펄스 폭 지터, 센서 클럭 오차 (모든 폭이 같은 비율로 늘거나 줄어듦)
+ *  - 체크섬 불일치, edge 누락, 40비트보다 짧은 응답
+ * 시각은 시작 신호를 놓은 뒤부터의 us, 첫 edge는 센서가 라인을 내리는 falling
+ ***************************************************************************/
+typedef struct {
+    unsigned int us;
+    int rising;
+} DhtVectorEdge;
+
+static int s_failed = 0;
+
+#define CHECK(cond, ...) do { \
+    if (!(cond)) { \
+        printf("FAIL %s:%d : ", __FILE__, __LINE__); \
+        printf(__VA_ARGS__); \
+        printf("\n"); \
+        s_failed++; \
+    } \
+} while (0)
+
+// 깨끗한 응답 : DHT11 습도 55.0%, 온도 24.7C
+static const DhtVectorEdge s_clean[] = {
+    { 30, 0 }, { 110, 1 }, { 190, 0 }, { 240, 1 }, { 266, 0 }, { 316, 1 }, { 342, 0 }, { 392, 1 },
+    { 462, 0 }, { 512, 1 }, { 582, 0 }, { 632, 1 }, { 658, 0 }, { 708, 1 }, { 778, 0 }, { 828, 1 },
+    { 898, 0 }, { 948, 1 }, { 1018, 0 }, { 1068, 1 }, { 1094, 0 }, { 1144, 1 }, { 1170, 0 },
+    { 1220, 1 }, { 1246, 0 }, { 1296, 1 }, { 1322, 0 }, { 1372, 1 }, { 1398, 0 }, { 1448, 1 },
+    { 1474, 0 }, { 1524, 1 }, { 1550, 0 }, { 1600, 1 }, { 1626, 0 }, { 1676, 1 }, { 1702, 0 },
+    { 1752, 1 }, { 1778, 0 }, { 1828, 1 }, { 1854, 0 }, { 1904, 1 }, { 1974, 0 }, { 2024, 1 },
+    { 2094, 0 }, { 2144, 1 }, { 2170, 0 }, { 2220, 1 }, { 2246, 0 }, { 2296, 1 }, { 2322, 0 },
+    { 2372, 1 }, { 2398, 0 }, { 2448, 1 }, { 2474, 0 }, { 2524, 1 }, { 2550, 0 }, { 2600, 1 },
+    { 2626, 0 }, { 2676, 1 }, { 2702, 0 }, { 2752, 1 }, { 2822, 0 }, { 2872, 1 }, { 2942, 0 },
+    { 2992, 1 }, { 3062, 0 }, { 3112, 1 }, { 3138, 0 }, { 3188, 1 }, { 3258, 0 }, { 3308, 1 },
+    { 3334, 0 }, { 3384, 1 }, { 3454, 0 }, { 3504, 1 }, { 3530, 0 }, { 3580, 1 }, { 3650, 0 },
+    { 3700, 1 }, { 3770, 0 }, { 3820, 1 }, { 3846, 0 }, { 3896, 1 },
+};
+
+// DHT22 : 습도 65.2%, 온도 -10.1C (온도 최상위 비트가 부호)
+static const DhtVectorEdge s_dht22[] = {
+    { 30, 0 }, { 110, 1 }, { 190, 0 }, { 240, 1 }, { 266, 0 }, { 316, 1 }, { 342, 0 }, { 392, 1 },
+    { 418, 0 }, { 468, 1 }, { 494, 0 }, { 544, 1 }, { 570, 0 }, { 620, 1 }, { 646, 0 }, { 696, 1 },
+    { 766, 0 }, { 816, 1 }, { 842, 0 }, { 892, 1 }, { 962, 0 }, { 1012, 1 }, { 1038, 0 },
+    { 1088, 1 }, { 1114, 0 }, { 1164, 1 }, { 1190, 0 }, { 1240, 1 }, { 1310, 0 }, { 1360, 1 },
+    { 1430, 0 }, { 1480, 1 }, { 1506, 0 }, { 1556, 1 }, { 1582, 0 }, { 1632, 1 }, { 1702, 0 },
+    { 1752, 1 }, { 1778, 0 }, { 1828, 1 }, { 1854, 0 }, { 1904, 1 }, { 1930, 0 }, { 1980, 1 },
+    { 2006, 0 }, { 2056, 1 }, { 2082, 0 }, { 2132, 1 }, { 2158, 0 }, { 2208, 1 }, { 2234, 0 },
+    { 2284, 1 }, { 2310, 0 }, { 2360, 1 }, { 2430, 0 }, { 2480, 1 }, { 2550, 0 }, { 2600, 1 },
+    { 2626, 0 }, { 2676, 1 }, { 2702, 0 }, { 2752, 1 }, { 2822, 0 }, { 2872, 1 }, { 2898, 0 },
+    { 2948, 1 }, { 3018, 0 }, { 3068, 1 }, { 3094, 0 }, { 3144, 1 }, { 3214, 0 }, { 3264, 1 },
+    { 3334, 0 }, { 3384, 1 }, { 3454, 0 }, { 3504, 1 }, { 3530, 0 }, { 3580, 1 }, { 3606, 0 },
+    { 3656, 1 }, { 3726, 0 }, { 3776, 1 }, { 3846, 0 }, { 3896, 1 },
+};
+
+// 펄스 폭마다 ±8us 지터 (같은 값)
+static const DhtVectorEdge s_jitter[] = {
+    { 30, 0 }, { 112, 1 }, { 188, 0 }, { 242, 1 }, { 261, 0 }, { 305, 1 }, { 326, 0 }, { 379, 1 },
+    { 442, 0 }, { 500, 1 }, { 568, 0 }, { 611, 1 }, { 631, 0 }, { 686, 1 }, { 761, 0 }, { 805, 1 },
+    { 874, 0 }, { 918, 1 }, { 993, 0 }, { 1036, 1 }, { 1057, 0 }, { 1106, 1 }, { 1125, 0 },
+    { 1179, 1 }, { 1198, 0 }, { 1247, 1 }, { 1266, 0 }, { 1312, 1 }, { 1339, 0 }, { 1394, 1 },
+    { 1416, 0 }, { 1461, 1 }, { 1488, 0 }, { 1535, 1 }, { 1556, 0 }, { 1604, 1 }, { 1633, 0 },
+    { 1678, 1 }, { 1698, 0 }, { 1741, 1 }, { 1765, 0 }, { 1822, 1 }, { 1897, 0 }, { 1949, 1 },
+    { 2025, 0 }, { 2081, 1 }, { 2110, 0 }, { 2161, 1 }, { 2186, 0 }, { 2233, 1 }, { 2258, 0 },
+    { 2302, 1 }, { 2329, 0 }, { 2387, 1 }, { 2420, 0 }, { 2472, 1 }, { 2504, 0 }, { 2555, 1 },
+    { 2575, 0 }, { 2620, 1 }, { 2654, 0 }, { 2709, 1 }, { 2776, 0 }, { 2828, 1 }, { 2894, 0 },
+    { 2951, 1 }, { 3026, 0 }, { 3069, 1 }, { 3089, 0 }, { 3141, 1 }, { 3213, 0 }, { 3266, 1 },
+    { 3299, 0 }, { 3355, 1 }, { 3419, 0 }, { 3463, 1 }, { 3489, 0 }, { 3546, 1 }, { 3610, 0 },
+    { 3653, 1 }, { 3724, 0 }, { 3780, 1 }, { 3807, 0 }, { 3861, 1 },
+};
+
+// 센서 클럭이 25% 느림 (모든 폭 x1.25)
+static const DhtVectorEdge s_slow[] = {
+    { 30, 0 }, { 130, 1 }, { 230, 0 }, { 292, 1 }, { 324, 0 }, { 386, 1 }, { 418, 0 }, { 480, 1 },
+    { 568, 0 }, { 630, 1 }, { 718, 0 }, { 780, 1 }, { 812, 0 }, { 874, 1 }, { 962, 0 }, { 1024, 1 },
+    { 1112, 0 }, { 1174, 1 }, { 1262, 0 }, { 1324, 1 }, { 1356, 0 }, { 1418, 1 }, { 1450, 0 },
+    { 1512, 1 }, { 1544, 0 }, { 1606, 1 }, { 1638, 0 }, { 1700, 1 }, { 1732, 0 }, { 1794, 1 },
+    { 1826, 0 }, { 1888, 1 }, { 1920, 0 }, { 1982, 1 }, { 2014, 0 }, { 2076, 1 }, { 2108, 0 },
+    { 2170, 1 }, { 2202, 0 }, { 2264, 1 }, { 2296, 0 }, { 2358, 1 }, { 2446, 0 }, { 2508, 1 },
+    { 2596, 0 }, { 2658, 1 }, { 2690, 0 }, { 2752, 1 }, { 2784, 0 }, { 2846, 1 }, { 2878, 0 },
+    { 2940, 1 }, { 2972, 0 }, { 3034, 1 }, { 3066, 0 }, { 3128, 1 }, { 3160, 0 }, { 3222, 1 },
+    { 3254, 0 }, { 3316, 1 }, { 3348, 0 }, { 3410, 1 }, { 3498, 0 }, { 3560, 1 }, { 3648, 0 },
+    { 3710, 1 }, { 3798, 0 }, { 3860, 1 }, { 3892, 0 }, { 3954, 1 }, { 4042, 0 }, { 4104, 1 },
+    { 4136, 0 }, { 4198, 1 }, { 4286, 0 }, { 4348, 1 }, { 4380, 0 }, { 4442, 1 }, { 4530, 0 },
+    { 4592, 1 }, { 4680, 0 }, { 4742, 1 }, { 4774, 0 }, { 4836, 1 },
+};
+
+// 센서 클럭이 20% 빠름 (모든 폭 x0.8) + ±3us 지터
+static const DhtVectorEdge s_fast[] = {
+    { 30, 0 }, { 92, 1 }, { 157, 0 }, { 198, 1 }, { 217, 0 }, { 256, 1 }, { 278, 0 }, { 318, 1 },
+    { 376, 0 }, { 417, 1 }, { 470, 0 }, { 511, 1 }, { 529, 0 }, { 572, 1 }, { 628, 0 }, { 667, 1 },
+    { 724, 0 }, { 762, 1 }, { 816, 0 }, { 858, 1 }, { 879, 0 }, { 920, 1 }, { 944, 0 }, { 985, 1 },
+    { 1006, 0 }, { 1046, 1 }, { 1069, 0 }, { 1112, 1 }, { 1131, 0 }, { 1169, 1 }, { 1192, 0 },
+    { 1230, 1 }, { 1254, 0 }, { 1295, 1 }, { 1316, 0 }, { 1358, 1 }, { 1376, 0 }, { 1418, 1 },
+    { 1442, 0 }, { 1479, 1 }, { 1498, 0 }, { 1541, 1 }, { 1598, 0 }, { 1635, 1 }, { 1690, 0 },
+    { 1733, 1 }, { 1751, 0 }, { 1794, 1 }, { 1818, 0 }, { 1857, 1 }, { 1878, 0 }, { 1919, 1 },
+    { 1942, 0 }, { 1982, 1 }, { 2005, 0 }, { 2048, 1 }, { 2069, 0 }, { 2109, 1 }, { 2132, 0 },
+    { 2175, 1 }, { 2197, 0 }, { 2237, 1 }, { 2291, 0 }, { 2330, 1 }, { 2383, 0 }, { 2420, 1 },
+    { 2474, 0 }, { 2514, 1 }, { 2533, 0 }, { 2572, 1 }, { 2630, 0 }, { 2670, 1 }, { 2694, 0 },
+    { 2736, 1 }, { 2795, 0 }, { 2834, 1 }, { 2855, 0 }, { 2896, 1 }, { 2955, 0 }, { 2995, 1 },
+    { 3052, 0 }, { 3091, 1 }, { 3113, 0 }, { 3154, 1 },
+};
+
+// 체크섬 마지막 비트가 뒤집힘
+static const DhtVectorEdge s_checksum[] = {
+    { 30, 0 }, { 110, 1 }, { 190, 0 }, { 240, 1 }, { 266, 0 }, { 316, 1 }, { 342, 0 }, { 392, 1 },
+    { 462, 0 }, { 512, 1 }, { 582, 0 }, { 632, 1 }, { 658, 0 }, { 708, 1 }, { 778, 0 }, { 828, 1 },
+    { 898, 0 }, { 948, 1 }, { 1018, 0 }, { 1068, 1 }, { 1094, 0 }, { 1144, 1 }, { 1170, 0 },
+    { 1220, 1 }, { 1246, 0 }, { 1296, 1 }, { 1322, 0 }, { 1372, 1 }, { 1398, 0 }, { 1448, 1 },
+    { 1474, 0 }, { 1524, 1 }, { 1550, 0 }, { 1600, 1 }, { 1626, 0 }, { 1676, 1 }, { 1702, 0 },
+    { 1752, 1 }, { 1778, 0 }, { 1828, 1 }, { 1854, 0 }, { 1904, 1 }, { 1974, 0 }, { 2024, 1 },
+    { 2094, 0 }, { 2144, 1 }, { 2170, 0 }, { 2220, 1 }, { 2246, 0 }, { 2296, 1 }, { 2322, 0 },
+    { 2372, 1 }, { 2398, 0 }, { 2448, 1 }, { 2474, 0 }, { 2524, 1 }, { 2550, 0 }, { 2600, 1 },
+    { 2626, 0 }, { 2676, 1 }, { 2702, 0 }, { 2752, 1 }, { 2822, 0 }, { 2872, 1 }, { 2942, 0 },
+    { 2992, 1 }, { 3062, 0 }, { 3112, 1 }, { 3138, 0 }, { 3188, 1 }, { 3258, 0 }, { 3308, 1 },
+    { 3334, 0 }, { 3384, 1 }, { 3454, 0 }, { 3504, 1 }, { 3530, 0 }, { 3580, 1 }, { 3650, 0 },
+    { 3700, 1 }, { 3770, 0 }, { 3820, 1 }, { 3890, 0 }, { 3940, 1 },
+};
+
+// 응답(80us) 펄스의 rising edge 누락 : 데이터 40비트는 그대로
+static const DhtVectorEdge s_drop_preamble[] = {
+    { 30, 0 }, { 190, 0 }, { 240, 1 }, { 266, 0 }, { 316, 1 }, { 342, 0 }, { 392, 1 }, { 462, 0 },
+    { 512, 1 }, { 582, 0 }, { 632, 1 }, { 658, 0 }, { 708, 1 }, { 778, 0 }, { 828, 1 }, { 898, 0 },
+    { 948, 1 }, { 1018, 0 }, { 1068, 1 }, { 1094, 0 }, { 1144, 1 }, { 1170, 0 }, { 1220, 1 },
+    { 1246, 0 }, { 1296, 1 }, { 1322, 0 }, { 1372, 1 }, { 1398, 0 }, { 1448, 1 }, { 1474, 0 },
+    { 1524, 1 }, { 1550, 0 }, { 1600, 1 }, { 1626, 0 }, { 1676, 1 }, { 1702, 0 }, { 1752, 1 },
+    { 1778, 0 }, { 1828, 1 }, { 1854, 0 }, { 1904, 1 }, { 1974, 0 }, { 2024, 1 }, { 2094, 0 },
+    { 2144, 1 }, { 2170, 0 }, { 2220, 1 }, { 2246, 0 }, { 2296, 1 }, { 2322, 0 }, { 2372, 1 },
+    { 2398, 0 }, { 2448, 1 }, { 2474, 0 }, { 2524, 1 }, { 2550, 0 }, { 2600, 1 }, { 2626, 0 },
+    { 2676, 1 }, { 2702, 0 }, { 2752, 1 }, { 2822, 0 }, { 2872, 1 }, { 2942, 0 }, { 2992, 1 },
+    { 3062, 0 }, { 3112, 1 }, { 3138, 0 }, { 3188, 1 }, { 3258, 0 }, { 3308, 1 }, { 3334, 0 },
+    { 3384, 1 }, { 3454, 0 }, { 3504, 1 }, { 3530, 0 }, { 3580, 1 }, { 3650, 0 }, { 3700, 1 },
+    { 3770, 0 }, { 3820, 1 }, { 3846, 0 }, { 3896, 1 },
+};
+
+// 13번째 데이터 비트의 rising edge 누락 : 응답 펄스가 데이터로 들어와 비트가 한 칸씩 밀림
+static const DhtVectorEdge s_drop_bit[] = {
+    { 30, 0 }, { 110, 1 }, { 190, 0 }, { 240, 1 }, { 266, 0 }, { 316, 1 }, { 342, 0 }, { 392, 1 },
+    { 462, 0 }, { 512, 1 }, { 582, 0 }, { 632, 1 }, { 658, 0 }, { 708, 1 }, { 778, 0 }, { 828, 1 },
+    { 898, 0 }, { 948, 1 }, { 1018, 0 }, { 1068, 1 }, { 1094, 0 }, { 1144, 1 }, { 1170, 0 },
+    { 1220, 1 }, { 1246, 0 }, { 1296, 1 }, { 1322, 0 }, { 1398, 0 }, { 1448, 1 }, { 1474, 0 },
+    { 1524, 1 }, { 1550, 0 }, { 1600, 1 }, { 1626, 0 }, { 1676, 1 }, { 1702, 0 }, { 1752, 1 },
+    { 1778, 0 }, { 1828, 1 }, { 1854, 0 }, { 1904, 1 }, { 1974, 0 }, { 2024, 1 }, { 2094, 0 },
+    { 2144, 1 }, { 2170, 0 }, { 2220, 1 }, { 2246, 0 }, { 2296, 1 }, { 2322, 0 }, { 2372, 1 },
+    { 2398, 0 }, { 2448, 1 }, { 2474, 0 }, { 2524, 1 }, { 2550, 0 }, { 2600, 1 }, { 2626, 0 },
+    { 2676, 1 }, { 2702, 0 }, { 2752, 1 }, { 2822, 0 }, { 2872, 1 }, { 2942, 0 }, { 2992, 1 },
+    { 3062, 0 }, { 3112, 1 }, { 3138, 0 }, { 3188, 1 }, { 3258, 0 }, { 3308, 1 }, { 3334, 0 },
+    { 3384, 1 }, { 3454, 0 }, { 3504, 1 }, { 3530, 0 }, { 3580, 1 }, { 3650, 0 }, { 3700, 1 },
+    { 3770, 0 }, { 3820, 1 }, { 3846, 0 }, { 3896, 1 },
+};
+
+// 13번째 데이터 비트의 falling edge 누락 : 앞뒤 펄스 두 개를 잃음
+static const DhtVectorEdge s_drop_fall[] = {
+    { 30, 0 }, { 110, 1 }, { 190, 0 }, { 240, 1 }, { 266, 0 }, { 316, 1 }, { 342, 0 }, { 392, 1 },
+    { 462, 0 }, { 512, 1 }, { 582, 0 }, { 632, 1 }, { 658, 0 }, { 708, 1 }, { 778, 0 }, { 828, 1 },
+    { 898, 0 }, { 948, 1 }, { 1018, 0 }, { 1068, 1 }, { 1094, 0 }, { 1144, 1 }, { 1170, 0 },
+    { 1220, 1 }, { 1246, 0 }, { 1296, 1 }, { 1322, 0 }, { 1372, 1 }, { 1448, 1 }, { 1474, 0 },
+    { 1524, 1 }, { 1550, 0 }, { 1600, 1 }, { 1626, 0 }, { 1676, 1 }, { 1702, 0 }, { 1752, 1 },
+    { 1778, 0 }, { 1828, 1 }, { 1854, 0 }, { 1904, 1 }, { 1974, 0 }, { 2024, 1 }, { 2094, 0 },
+    { 2144, 1 }, { 2170, 0 }, { 2220, 1 }, { 2246, 0 }, { 2296, 1 }, { 2322, 0 }, { 2372, 1 },
+    { 2398, 0 }, { 2448, 1 }, { 2474, 0 }, { 2524, 1 }, { 2550, 0 }, { 2600, 1 }, { 2626, 0 },
+    { 2676, 1 }, { 2702, 0 }, { 2752, 1 }, { 2822, 0 }, { 2872, 1 }, { 2942, 0 }, { 2992, 1 },
+    { 3062, 0 }, { 3112, 1 }, { 3138, 0 }, { 3188, 1 }, { 3258, 0 }, { 3308, 1 }, { 3334, 0 },
+    { 3384, 1 }, { 3454, 0 }, { 3504, 1 }, { 3530, 0 }, { 3580, 1 }, { 3650, 0 }, { 3700, 1 },
+    { 3770, 0 }, { 3820, 1 }, { 3846, 0 }, { 3896, 1 },
+};
+
+// 30비트에서 끊긴 응답
+static const DhtVectorEdge s_truncated[] = {
+    { 30, 0 }, { 110, 1 }, { 190, 0 }, { 240, 1 }, { 266, 0 }, { 316, 1 }, { 342, 0 }, { 392, 1 },
+    { 462, 0 }, { 512, 1 }, { 582, 0 }, { 632, 1 }, { 658, 0 }, { 708, 1 }, { 778, 0 }, { 828, 1 },
+    { 898, 0 }, { 948, 1 }, { 1018, 0 }, { 1068, 1 }, { 1094, 0 }, { 1144, 1 }, { 1170, 0 },
+    { 1220, 1 }, { 1246, 0 }, { 1296, 1 }, { 1322, 0 }, { 1372, 1 }, { 1398, 0 }, { 1448, 1 },
+    { 1474, 0 }, { 1524, 1 }, { 1550, 0 }, { 1600, 1 }, { 1626, 0 }, { 1676, 1 }, { 1702, 0 },
+    { 1752, 1 }, { 1778, 0 }, { 1828, 1 }, { 1854, 0 }, { 1904, 1 }, { 1974, 0 }, { 2024, 1 },
+    { 2094, 0 }, { 2144, 1 }, { 2170, 0 }, { 2220, 1 }, { 2246, 0 }, { 2296, 1 }, { 2322, 0 },
+    { 2372, 1 }, { 2398, 0 }, { 2448, 1 }, { 2474, 0 }, { 2524, 1 }, { 2550, 0 }, { 2600, 1 },
+    { 2626, 0 }, { 2676, 1 }, { 2702, 0 }, { 2752, 1 }, { 2822, 0 },
+};
+
+#define VECTOR(v) v, (int)(sizeof(v) / sizeof(v[0]))
+
+static DhtResult decode(const DhtVectorEdge *v, int count, DhtType type) {
+    HalEdge edges[DHT_MAX_EDGES];
+
+    for (int i = 0; i < count; i++) {
+        edges[i].ts_ns = 1000000000ULL + (uint64_t)v[i].us * 1000;
+        edges[i].rising = v[i].rising;
+    }
+    return dht_decode(edges, count, type);
+}
+
+// 성공해야 하는 응답 : 상태와 온도, 습도 확인
+static void expect_value(const char *name, const DhtVectorEdge *v, int count, DhtType type, float temp, float humid) {
+    DhtResult r = decode(v, count, type);
+
+    CHECK(r.status == DHT_OK, "%s : %s", name, dht_status_str(r.status));
+    if (r.status == DHT_OK) {
+        CHECK(fabsf(r.temp - temp) < 0.05f && fabsf(r.humid - humid) < 0.05f,
+              "%s : temp %.1f humid %.1f, expected %.1f %.1f", name, r.temp, r.humid, temp, humid);
+    }
+}
+
+// 실패해야 하는 응답 : 원인 확인
+static void expect_error(const char *name, const DhtVectorEdge *v, int count, DhtStatus status) {
+    DhtResult r = decode(v, count, DHT11);
+
+    CHECK(r.status == status, "%s : %s, expected %s", name, dht_status_str(r.status), dht_status_str(status));
+}
+
+int main(void) {
+    expect_value("clean", VECTOR(s_clean), DHT11, 24.7f, 55.0f);
+    expect_value("dht22", VECTOR(s_dht22), DHT22, -10.1f, 65.2f);
+    expect_value("jitter", VECTOR(s_jitter), DHT11, 24.7f, 55.0f);
+    expect_value("slow clock", VECTOR(s_slow), DHT11, 24.7f, 55.0f);
+    expect_value("fast clock", VECTOR(s_fast), DHT11, 24.7f, 55.0f);
+    expect_value("dropped preamble edge", VECTOR(s_drop_preamble), DHT11, 24.7f, 55.0f);
+
+    expect_error("checksum", VECTOR(s_checksum), DHT_CHECKSUM);
+    expect_error("dropped rising edge", VECTOR(s_drop_bit), DHT_CHECKSUM);
+    expect_error("dropped falling edge", VECTOR(s_drop_fall), DHT_SHORT_FRAME);
+    expect_error("truncated", VECTOR(s_truncated), DHT_SHORT_FRAME);
+    expect_error("no response", s_clean, 0, DHT_NO_RESPONSE);
+
+    if (s_failed) {
+        printf("%d checks FAILED\n", s_failed);
+        return 1;
+    }
+    printf("all checks passed\n");
+    return 0;
+}
@@ -0,0 +1,140 @@
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+#include <pthread.h>
+
+#include "lcd.h"
+#include "display.h"
+
+static pthread_t s_thread;
+static pthread_mutex_t s_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t s_cond;
+static int s_running = 0;
+static int s_quit = 0;
+
+// 아직 그려지지 않은 요청 (하나만 보관, 새 요청이 오면 덮어씀)
+static DisplayScreen s_pending[DISPLAY_SCREENS_MAX];
+static int s_pending_count = 0;
+static long s_replaced = 0; // 그려지기 전에 교체된 요청 수
+
+// 그린 화면을 hold_ms 동안 유지 (s_mutex를 잡은 상태로 호출)
+// 새 요청이 와도 유지 시간은 지키고, 종료 요청이 오면 바로 반환
+static void display_hold(int hold_ms) {
+    struct timespec deadline;
+
+    if (hold_ms <= 0) {
+        return;
+    }
+    clock_gettime(CLOCK_MONOTONIC, &deadline);
+    deadline.tv_sec += hold_ms / 1000;
+    deadline.tv_nsec += (hold_ms % 1000) * 1000000L;
+    if (deadline.tv_nsec >= 1000000000L) {
+        deadline.tv_sec++;
+        deadline.tv_nsec -= 1000000000L;
+    }
+    while (!s_quit && pthread_cond_timedwait(&s_cond, &s_mutex, &deadline) != ETIMEDOUT) {
+    }
+}
+
+/***************************************************************************
+ * display_main(void *arg)
+ * 화면 스레드 : 요청을 꺼내 화면을 하나씩 그리고 각 화면의 표시 시간만큼 기다림
+ * 다음 화면으로 넘어가기 전에 새 요청이 와 있으면 남은 화면은 버리고 새 요청을 그림
+ ***************************************************************************/
+static void *display_main(void *arg) {
+    DisplayScreen screens[DISPLAY_SCREENS_MAX];
+    int count;
+
+    pthread_mutex_lock(&s_mutex);
+    while (!s_quit) {
+        if (s_pending_count == 0) {
+            pthread_cond_wait(&s_cond, &s_mutex);
+            continue;
+        }
+        count = s_pending_count;
+        memcpy(screens, s_pending, count * sizeof(DisplayScreen));
+        s_pending_count = 0;
+
+        for (int i = 0; i < count && !s_quit; i++) {
+            if (i > 0 && s_pending_count > 0) {
+                break;
+            }
+            // LCD 전송 중에도 다른 스레드가 요청을 넣을 수 있도록 잠금 해제
+            pthread_mutex_unlock(&s_mutex);
+            lcd_render(screens[i].line1, screens[i].line2);
+            pthread_mutex_lock(&s_mutex);
+            display_hold(screens[i].hold_ms);
+        }
+    }
+    pthread_mutex_unlock(&s_mutex);
+    return NULL;
+}
+
+int display_start(void) {
+    pthread_condattr_t attr;
+
+    if (s_running) {
+        return 0;
+    }
+
+    // 표시 시간이 시스템 시간 변경에 영향받지 않도록 MONOTONIC 사용
+    pthread_condattr_init(&attr);
+    pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+    pthread_cond_init(&s_cond, &attr);
+    pthread_condattr_destroy(&attr);
+
+    s_quit = 0;
+    s_pending_count = 0;
+    if (pthread_create(&s_thread, NULL, display_main, NULL) != 0) {
+        fprintf(stderr, "Failed to start display thread\n");
+        pthread_cond_destroy(&s_cond);
+        return -1;
+    }
+    s_running = 1;
+    return 0;
+}
+
+int display_show(const DisplayScreen *screens, int count) {
+    if (!s_running || count <= 0) {
+        return -1;
+    }
+    if (count > DISPLAY_SCREENS_MAX) {
+        count = DISPLAY_SCREENS_MAX;
+    }
+
+    pthread_mutex_lock(&s_mutex);
+    if (s_pending_count > 0) {
+        s_replaced++;
+    }
+    memcpy(s_pending, screens, count * sizeof(DisplayScreen));
+    s_pending_count = count;
+    pthread_cond_signal(&s_cond);
+    pthread_mutex_unlock(&s_mutex);
+    return 0;
+}
+
+int display_show_text(const char *line1, const char *line2, int hold_ms) {
+    DisplayScreen screen;
+
+    snprintf(screen.line1, sizeof(screen.line1), "%s", line1 ? line1 : "");
+    snprintf(screen.line2, sizeof(screen.line2), "%s", line2 ? line2 : "");
+    screen.hold_ms = hold_ms;
+    return display_show(&screen, 1);
+}
+
+void display_stop(void) {
+    if (!s_running) {
+        return;
+    }
+
+    pthread_mutex_lock(&s_mutex);
+    s_quit = 1;
+    pthread_cond_signal(&s_cond);
+    pthread_mutex_unlock(&s_mutex);
+
+    pthread_join(s_thread, NULL);
+    pthread_cond_destroy(&s_cond);
+    s_running = 0;
+    printf("display : %ld requests replaced before drawing\n", s_replaced);
+}
@@ -0,0 +1,37 @@
+#ifndef DISPLAY_H
+#define DISPLAY_H
+
+#include "lcd.h"
+
+// 요청 하나에 들어갈 수 있는 최대 화면 수
+#define DISPLAY_SCREENS_MAX 4
+
+// 화면 하나 : 두 줄 + 표시 시간
+typedef struct {
+    char line1[LCD_COLS + 1];
+    char line2[LCD_COLS + 1];
+    int hold_ms;  // 최소 표시 시간 (0 = 다음 요청이 올 때까지)
+} DisplayScreen;
+
+/***************************************************************************
+ * display_start()
+ * LCD를 그리는 화면 스레드 시작 (lcd_init 이후에 호출)
+ * 이후 LCD는 화면 스레드만 그리고, 다른 스레드는 display_show로 요청만 넣음
+ ***************************************************************************/
+int display_start(void);
+
+/***************************************************************************
+ * display_show(const DisplayScreen *screens, int count)
+ * 화면 여러 개를 순서대로 표시하도록 요청하고 바로 반환함
+ * 아직 그려지지 않은 이전 요청은 새 요청으로 교체됨 (최신 화면만 그림)
+ * 이미 그려진 화면은 hold_ms 동안 유지한 뒤 새 요청으로 넘어감
+ ***************************************************************************/
+int display_show(const DisplayScreen *screens, int count);
+
+// 화면 하나만 요청
+int display_show_text(const char *line1, const char *line2, int hold_ms);
+
+// 화면 스레드 종료 (남은 요청은 버림)
+void display_stop(void);
+
+#endif
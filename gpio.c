@@ -0,0 +1,35 @@
+#include "gpio.h"
+#include "hal.h"
+
+// GPIO 접근은 모두 현재 HAL 백엔드로 전달
+int GPIOExport(int pin) {
+    return hal()->gpio_export(pin);
+}
+
+int GPIOUnexport(int pin) {
+    return hal()->gpio_unexport(pin);
+}
+
+int GPIODirection(int pin, int dir) {
+    return hal()->gpio_direction(pin, dir);
+}
+
+int GPIORead(int pin) {
+    return hal()->gpio_read(pin);
+}
+
+int GPIOWrite(int pin, int value) {
+    return hal()->gpio_write(pin, value);
+}
+
+int GPIOSetEdge(int pin, const char *edge) {
+    return hal()->gpio_set_edge(pin, edge);
+}
+
+int GPIOPollFd(int pin, short *events) {
+    return hal()->gpio_poll_fd(pin, events);
+}
+
+int GPIOEdgeAck(int pin) {
+    return hal()->gpio_edge_ack(pin);
+}
@@ -0,0 +1,37 @@
+#ifndef GPIO_H
+#define GPIO_H
+
+// GPIO 설정값
+#define IN 0
+#define OUT 1
+#define LOW 0
+#define HIGH 1
+
+// 관리할 수 있는 최대 GPIO 핀 번호 (BCM 0 ~ 63)
+#define GPIO_PIN_MAX 64
+
+// GPIO 핀을 시스템에 내보내기
+int GPIOExport(int pin);
+
+// GPIO 핀을 시스템에서 제거 (열려 있는 파일 디스크립터도 함께 닫음)
+int GPIOUnexport(int pin);
+
+// GPIO 핀 방향 설정 (0 = 입력, 1 = 출력)
+int GPIODirection(int pin, int dir);
+
+// GPIO 핀 값 읽기
+int GPIORead(int pin);
+
+// GPIO 핀 값 쓰기
+int GPIOWrite(int pin, int value);
+
+// 인터럽트 edge 설정 ("none", "rising", "falling", "both")
+int GPIOSetEdge(int pin, const char *edge);
+
+// edge 대기용 파일 디스크립터와 poll()에 사용할 이벤트 반환 (닫지 말 것)
+int GPIOPollFd(int pin, short *events);
+
+// edge 알림을 해제하고 현재 핀 값 반환
+int GPIOEdgeAck(int pin);
+
+#endif
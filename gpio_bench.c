@@ -0,0 +1,173 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <string.h>
+#include <fcntl.h>
+#include <time.h>
+#include <sys/stat.h>
+
+#include "gpio.h"
+#include "hal.h"
+
+// 벤치마크 설정
+#define BENCH_PIN 20
+#define BENCH_ITERATIONS 200000
+#define PATH_MAX_LEN 128
+
+// 가짜 sysfs 트리 루트 (tmpfs)
+static char s_root[PATH_MAX_LEN / 2];
+
+/***************************************************************************
+ * legacy_read(int pin), legacy_write(int pin, int value)
+ * 기존 rpi1/rpi2/rpi3의 방식 그대로 매 호출마다
+ * snprintf + open + read/write + close 하는 함수
+ ***************************************************************************/
+static int legacy_read(int pin) {
+    char path[PATH_MAX_LEN];
+    char value_str[3];
+    int fd;
+
+    snprintf(path, PATH_MAX_LEN, "%s/gpio%d/value", s_root, pin);
+    fd = open(path, O_RDONLY);
+    if (fd == -1) {
+        return -1;
+    }
+    if (read(fd, value_str, 3) == -1) {
+        close(fd);
+        return -1;
+    }
+    close(fd);
+    return atoi(value_str);
+}
+
+static int legacy_write(int pin, int value) {
+    static const char s_values_str[] = "01";
+    char path[PATH_MAX_LEN];
+    int fd;
+
+    snprintf(path, PATH_MAX_LEN, "%s/gpio%d/value", s_root, pin);
+    fd = open(path, O_WRONLY);
+    if (fd == -1) {
+        return -1;
+    }
+    if (write(fd, &s_values_str[LOW == value ? 0 : 1], 1) != 1) {
+        close(fd);
+        return -1;
+    }
+    close(fd);
+    return 0;
+}
+
+// 현재 시간을 초 단위로 반환
+static double now_sec(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+// tmpfs 위에 /sys/class/gpio 와 같은 구조의 가짜 트리 생성
+static int make_fake_sysfs(int pin) {
+    char path[PATH_MAX_LEN];
+    const char *files[] = {"export", "unexport"};
+    int fd;
+
+    snprintf(s_root, sizeof(s_root), "/dev/shm/homefarm-gpio-%d", (int)getpid());
+    if (mkdir(s_root, 0755) == -1) {
+        perror("mkdir");
+        return -1;
+    }
+    for (int i = 0; i < 2; i++) {
+        snprintf(path, PATH_MAX_LEN, "%s/%s", s_root, files[i]);
+        if ((fd = open(path, O_CREAT | O_WRONLY, 0644)) == -1) {
+            perror(path);
+            return -1;
+        }
+        close(fd);
+    }
+
+    snprintf(path, PATH_MAX_LEN, "%s/gpio%d", s_root, pin);
+    mkdir(path, 0755);
+    snprintf(path, PATH_MAX_LEN, "%s/gpio%d/value", s_root, pin);
+    if ((fd = open(path, O_CREAT | O_WRONLY, 0644)) == -1) {
+        perror(path);
+        return -1;
+    }
+    write(fd, "0\n", 2);
+    close(fd);
+    snprintf(path, PATH_MAX_LEN, "%s/gpio%d/direction", s_root, pin);
+    if ((fd = open(path, O_CREAT | O_WRONLY, 0644)) == -1) {
+        perror(path);
+        return -1;
+    }
+    write(fd, "in\n", 3);
+    close(fd);
+    return 0;
+}
+
+// 가짜 sysfs 트리 삭제
+static void remove_fake_sysfs(int pin) {
+    char path[PATH_MAX_LEN];
+    const char *files[] = {"value", "direction"};
+
+    for (int i = 0; i < 2; i++) {
+        snprintf(path, PATH_MAX_LEN, "%s/gpio%d/%s", s_root, pin, files[i]);
+        unlink(path);
+    }
+    snprintf(path, PATH_MAX_LEN, "%s/gpio%d", s_root, pin);
+    rmdir(path);
+    snprintf(path, PATH_MAX_LEN, "%s/export", s_root);
+    unlink(path);
+    snprintf(path, PATH_MAX_LEN, "%s/unexport", s_root);
+    unlink(path);
+    rmdir(s_root);
+}
+
+// 결과 한 줄 출력
+static void report(const char *name, double elapsed) {
+    printf("%-16s %10.0f ops/sec  (%.1f ns/op)\n", name,
+           BENCH_ITERATIONS / elapsed, elapsed * 1e9 / BENCH_ITERATIONS);
+}
+
+/***************************************************************************
+ * main()
+ * tmpfs 가짜 sysfs 트리를 대상으로 기존 방식과 fd 캐시 방식의
+ * GPIO 읽기/쓰기 처리량(ops/sec)을 비교함
+ ***************************************************************************/
+int main() {
+    double start;
+    int sink = 0;
+
+    if (make_fake_sysfs(BENCH_PIN) == -1) {
+        return 1;
+    }
+    hal_sysfs_set_root(s_root);
+
+    start = now_sec();
+    for (int i = 0; i < BENCH_ITERATIONS; i++) {
+        sink += legacy_read(BENCH_PIN);
+    }
+    report("legacy read", now_sec() - start);
+
+    start = now_sec();
+    for (int i = 0; i < BENCH_ITERATIONS; i++) {
+        sink += GPIORead(BENCH_PIN);
+    }
+    report("cached read", now_sec() - start);
+
+    start = now_sec();
+    for (int i = 0; i < BENCH_ITERATIONS; i++) {
+        legacy_write(BENCH_PIN, i & 1);
+    }
+    report("legacy write", now_sec() - start);
+
+    start = now_sec();
+    for (int i = 0; i < BENCH_ITERATIONS; i++) {
+        GPIOWrite(BENCH_PIN, i & 1);
+    }
+    report("cached write", now_sec() - start);
+
+    // unexport 시 캐시된 fd 닫기 (가짜 unexport 파일에 기록됨)
+    GPIOUnexport(BENCH_PIN);
+    remove_fake_sysfs(BENCH_PIN);
+    return sink == -1;
+}
@@ -0,0 +1,26 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+
+#include "hal.h"
+
+static const HalOps *s_hal = NULL;
+static pthread_once_t s_hal_once = PTHREAD_ONCE_INIT;
+
+// 환경변수에 따라 백엔드 선택
+static void hal_select(void) {
+    const char *name = getenv("HOMEFARM_HAL");
+
+    if (name != NULL && strcmp(name, "sim") == 0) {
+        s_hal = &hal_sim_ops;
+    } else {
+        s_hal = &hal_sysfs_ops;
+    }
+    printf("HAL backend : %s\n", s_hal->name);
+}
+
+const HalOps *hal(void) {
+    pthread_once(&s_hal_once, hal_select);
+    return s_hal;
+}
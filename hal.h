@@ -0,0 +1,69 @@
+#ifndef HAL_H
+#define HAL_H
+
+#include <stdint.h>
+
+// 커널이 타임스탬프를 찍은 GPIO edge 이벤트
+typedef struct {
+    uint64_t ts_ns; // 이벤트 시각 (CLOCK_MONOTONIC, ns)
+    int rising;     // 1 = rising, 0 = falling
+} HalEdge;
+
+/***************************************************************************
+ * 하드웨어 추상화 계층 (HAL)
+ * GPIO, PWM, I2C 접근을 함수 테이블로 묶어 실제 보드(sysfs)와
+ * 메모리 안에서 동작하는 시뮬레이터를 바꿔 끼울 수 있게 함
+ * 환경변수 HOMEFARM_HAL=sim 이면 시뮬레이터, 그 외에는 sysfs 사용
+ ***************************************************************************/
+typedef struct {
+    const char *name;
+
+    // GPIO
+    int (*gpio_export)(int pin);
+    int (*gpio_unexport)(int pin);
+    int (*gpio_direction)(int pin, int dir);
+    int (*gpio_read)(int pin);
+    int (*gpio_write)(int pin, int value);
+    int (*gpio_set_edge)(int pin, const char *edge);
+    int (*gpio_poll_fd)(int pin, short *events); // edge 대기용 fd와 poll 이벤트
+    int (*gpio_edge_ack)(int pin);                // edge 알림 해제 후 현재 값 반환
+
+    // GPIO 캐릭터 디바이스 라인 이벤트 (양쪽 edge, 커널 타임스탬프)
+    // line_read: 1 = 이벤트 수신, 0 = timeout, -1 = 오류
+    int (*gpio_line_request)(int pin);
+    int (*gpio_line_read)(int handle, HalEdge *edge, int timeout_ms);
+    void (*gpio_line_release)(int handle);
+    // 라인을 low_us 동안 출력 LOW로 당긴 뒤 다시 입력(양쪽 edge)으로 되돌림 (DHT 시작 신호)
+    int (*gpio_line_pulse)(int handle, int low_us);
+
+    // PWM (attr: "period", "duty_cycle", "enable")
+    int (*pwm_export)(int pwmnum);
+    int (*pwm_unexport)(int pwmnum);
+    int (*pwm_write)(int pwmnum, const char *attr, long value);
+
+    // I2C
+    int (*i2c_open)(int bus, int addr);           // 장치 핸들 반환
+    int (*i2c_write)(int handle, const unsigned char *buf, int len);
+    void (*i2c_close)(int handle);
+} HalOps;
+
+// 현재 사용 중인 HAL 반환 (처음 호출될 때 환경변수로 선택)
+const HalOps *hal(void);
+
+// 백엔드
+extern const HalOps hal_sysfs_ops;
+extern const HalOps hal_sim_ops;
+
+// sysfs GPIO 루트 경로 변경 (기본값 /sys/class/gpio, 벤치마크용)
+void hal_sysfs_set_root(const char *root);
+
+// 시뮬레이터 LCD 화면 내용 복사 (2줄 x 16글자, 디버깅/벤치마크용)
+void hal_sim_lcd_snapshot(char line1[17], char line2[17]);
+
+// 시뮬레이터 I2C 누적 write 호출 수, 전송 바이트 수 (벤치마크용)
+void hal_sim_i2c_stats(long *writes, long *bytes);
+
+// 시뮬레이터 I2C 다음 writes번의 write를 EIO로 실패시키고 LCD를 리셋 (오류 처리 검증용)
+void hal_sim_i2c_fault(int writes);
+
+#endif
@@ -0,0 +1,676 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <string.h>
+#include <errno.h>
+#include <poll.h>
+#include <time.h>
+#include <stdint.h>
+#include <pthread.h>
+#include <sys/eventfd.h>
+
+#include "gpio.h"
+#include "hal.h"
+
+/***************************************************************************
+ * 시뮬레이터 HAL 백엔드
+ * 보드 없이 개발 PC에서 rpi1/rpi2/rpi3을 그대로 실행하기 위한 백엔드
+ * 입력 방향으로 설정된 핀에는 아래 센서 모델이 값을 만들어냄
+ *  - 초음파 센서(HC-SR04): TRIG 펄스 후 거리에 비례하는 ECHO 펄스
+ *    (라인 이벤트로 요청하면 edge 타임스탬프로 전달, 가끔 에코 누락)
+ *  - 수위 센서, 조도 센서: 주기적으로 부족/충분, 어두움/밝음 반복
+ *  - 버튼, 터치 센서: 주기적으로 눌림
+ *  - 온습도 센서(DHT11): 시작 신호 후 40비트 응답을 edge 타임스탬프로 전달
+ *    (펄스 폭에 지터가 있고 가끔 체크섬 오류, 무응답 발생)
+ * I2C 0x27 에는 PCF8574 + HD44780 LCD가 메모리에 모델링됨
+ * (hal_sim_i2c_fault로 버스 오류와 LCD 리셋을 만들 수 있음)
+ ***************************************************************************/
+
+// 센서 핀 번호 (rpi1/rpi2/rpi3 정의와 동일)
+#define SIM_TRIG_PIN 24
+#define SIM_ECHO_PIN 23
+#define SIM_WATER_LEVEL_PIN 25
+#define SIM_LIGHT_SENSOR_PIN 17
+#define SIM_BUTTON_PIN 20
+#define SIM_TOUCH_PIN 9
+#define SIM_DHT_PIN 27
+
+// 센서 모델 설정
+#define SIM_DISTANCE_START_CM 30.0 // 처음 식물까지의 거리
+#define SIM_DISTANCE_MIN_CM 5.0
+#define SIM_GROWTH_SEC_PER_CM 30.0 // 1cm 자라는 데 걸리는 시간
+#define SIM_ECHO_DELAY_US 200      // TRIG 후 ECHO가 올라가기까지의 시간
+#define SIM_ECHO_DROP_EVERY 25     // 이 횟수마다 한 번 에코가 돌아오지 않음
+#define SIM_WATER_PERIOD_SEC 90    // 이 주기의 마지막 30초 동안 물 부족
+#define SIM_WATER_LOW_SEC 30
+#define SIM_LIGHT_PERIOD_SEC 40    // 이 주기의 절반 동안 어두움
+#define SIM_BUTTON_PERIOD_MS 20000
+#define SIM_TOUCH_PERIOD_MS 7000
+#define SIM_PRESS_MS 150
+#define SIM_EDGE_TICK_US 5000      // edge 감시 주기
+#define SIM_DHT_JITTER_US 8        // DHT 펄스 폭 지터 (+-)
+#define SIM_DHT_CORRUPT_EVERY 10   // 이 횟수마다 한 번 비트 하나가 뒤집힘 (체크섬 오류)
+#define SIM_DHT_SILENT_EVERY 13    // 이 횟수마다 한 번 응답하지 않음
+
+// LCD (PCF8574 비트 배치)
+#define SIM_LCD_ADDR 0x27
+#define SIM_LCD_RS 0x01
+#define SIM_LCD_EN 0x04
+#define SIM_LCD_COLS 16
+
+#define SIM_LINE_QUEUE 128         // 라인 이벤트 큐 크기 (DHT 응답 한 번 이상)
+
+#define EDGE_NONE 0
+#define EDGE_RISING 1
+#define EDGE_FALLING 2
+#define EDGE_BOTH 3
+
+typedef struct {
+    int exported;
+    int dir;
+    int value;      // 출력 핀 값 (센서 모델이 없는 입력 핀 값)
+    int edge;       // EDGE_*
+    int last_value; // edge 감시용 이전 값
+    int efd;        // edge 알림용 eventfd (-1 = 없음)
+} SimPin;
+
+typedef struct {
+    int exported;
+    long period;
+    long duty_cycle;
+    long enable;
+} SimPwm;
+
+typedef struct {
+    int prev;          // 이전에 쓴 바이트 (EN falling 검출용)
+    int mode8;         // 초기화 전 8비트 모드
+    int nibble_pending;
+    int high_nibble;
+    int addr;          // DDRAM 주소
+    int dirty;         // 출력 이후 변경 여부
+    char chars[2][SIM_LCD_COLS + 1];
+} SimLcd;
+
+// 캐릭터 디바이스 라인 이벤트 큐 (핀 번호가 핸들)
+typedef struct {
+    int requested;
+    int head;
+    int count;
+    HalEdge events[SIM_LINE_QUEUE];
+} SimLine;
+
+static SimPin s_pins[GPIO_PIN_MAX];
+static SimLine s_lines[GPIO_PIN_MAX];
+static pthread_cond_t s_line_cond;
+static int s_trig_count = 0;
+static int s_dht_count = 0;
+static unsigned int s_dht_seed = 1;
+static SimPwm s_pwm[2];
+static SimLcd s_lcd;
+static long s_i2c_writes = 0; // I2C write 호출(트랜잭션) 수
+static long s_i2c_bytes = 0;  // I2C로 전송된 데이터 바이트 수
+static int s_i2c_faults = 0;  // 앞으로 실패시킬 I2C write 수
+static struct timespec s_start;
+static long long s_trig_ns = -1; // 마지막 TRIG falling 시각
+static int s_edge_thread_started = 0;
+static pthread_mutex_t s_sim_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_once_t s_sim_once = PTHREAD_ONCE_INIT;
+
+// LCD 전원 투입 상태 (8비트 모드, 빈 화면)
+static void sim_lcd_reset(void) {
+    memset(&s_lcd, 0, sizeof(s_lcd));
+    s_lcd.mode8 = 1;
+    for (int i = 0; i < 2; i++) {
+        memset(s_lcd.chars[i], ' ', SIM_LCD_COLS);
+        s_lcd.chars[i][SIM_LCD_COLS] = '\0';
+    }
+}
+
+// 시뮬레이터 초기화
+static void sim_init(void) {
+    pthread_condattr_t attr;
+
+    clock_gettime(CLOCK_MONOTONIC, &s_start);
+    pthread_condattr_init(&attr);
+    pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+    pthread_cond_init(&s_line_cond, &attr);
+    pthread_condattr_destroy(&attr);
+    for (int i = 0; i < GPIO_PIN_MAX; i++) {
+        s_pins[i].efd = -1;
+    }
+    sim_lcd_reset();
+}
+
+// CLOCK_MONOTONIC 현재 시각 (ns)
+static uint64_t mono_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+// 시뮬레이터 시작 후 경과 시간 (ns)
+static long long sim_now_ns(void) {
+    struct timespec ts;
+    pthread_once(&s_sim_once, sim_init);
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (ts.tv_sec - s_start.tv_sec) * 1000000000LL + (ts.tv_nsec - s_start.tv_nsec);
+}
+
+static int valid_pin(int pin) {
+    pthread_once(&s_sim_once, sim_init);
+    if (pin < 0 || pin >= GPIO_PIN_MAX) {
+        errno = EINVAL;
+        return 0;
+    }
+    return 1;
+}
+
+// 현재 시간 기준 식물까지의 거리 (식물이 자라면서 가까워짐)
+static double sim_distance_cm(long long now_ns) {
+    double d = SIM_DISTANCE_START_CM - (now_ns / 1e9) / SIM_GROWTH_SEC_PER_CM;
+    return d < SIM_DISTANCE_MIN_CM ? SIM_DISTANCE_MIN_CM : d;
+}
+
+// 주기적으로 press_ms 동안 눌리는 입력 (offset_ms 만큼 늦게 시작)
+static int sim_pressed(long long now_ns, long period_ms, long offset_ms) {
+    long long ms = now_ns / 1000000 - offset_ms;
+    return ms >= 0 && (ms % period_ms) < SIM_PRESS_MS;
+}
+
+// 센서 모델 값 계산 (s_sim_mutex 잠긴 상태에서 호출), 모델이 없으면 -1
+static int sim_model_value(int pin, long long now_ns) {
+    long long sec = now_ns / 1000000000LL;
+
+    switch (pin) {
+        case SIM_ECHO_PIN: {
+            if (s_trig_ns < 0) {
+                return LOW;
+            }
+            long long rise = s_trig_ns + SIM_ECHO_DELAY_US * 1000LL;
+            long long width = (long long)(sim_distance_cm(s_trig_ns) * 2 / 34300.0 * 1e9);
+            return now_ns >= rise && now_ns < rise + width ? HIGH : LOW;
+        }
+        case SIM_WATER_LEVEL_PIN:
+            // 0 = 물 부족
+            return sec % SIM_WATER_PERIOD_SEC >= SIM_WATER_PERIOD_SEC - SIM_WATER_LOW_SEC ? LOW : HIGH;
+        case SIM_LIGHT_SENSOR_PIN:
+            // 0 = 어두움
+            return sec % SIM_LIGHT_PERIOD_SEC < SIM_LIGHT_PERIOD_SEC / 2 ? HIGH : LOW;
+        case SIM_BUTTON_PIN:
+            // 풀업 버튼, 눌리면 LOW
+            return sim_pressed(now_ns, SIM_BUTTON_PERIOD_MS, 5000) ? LOW : HIGH;
+        case SIM_TOUCH_PIN:
+            // 터치되면 HIGH
+            return sim_pressed(now_ns, SIM_TOUCH_PERIOD_MS, 3000) ? HIGH : LOW;
+        default:
+            return -1;
+    }
+}
+
+// 핀의 현재 값 (s_sim_mutex 잠긴 상태에서 호출)
+static int sim_pin_value(int pin, long long now_ns) {
+    if (s_pins[pin].dir == IN) {
+        int value = sim_model_value(pin, now_ns);
+        if (value != -1) {
+            return value;
+        }
+    }
+    return s_pins[pin].value;
+}
+
+// edge 감시 스레드: 센서 모델 값이 바뀌면 eventfd로 알림
+static void *sim_edge_thread(void *arg) {
+    while (1) {
+        long long now = sim_now_ns();
+
+        pthread_mutex_lock(&s_sim_mutex);
+        for (int pin = 0; pin < GPIO_PIN_MAX; pin++) {
+            SimPin *p = &s_pins[pin];
+            if (p->edge == EDGE_NONE || p->efd == -1) {
+                continue;
+            }
+
+            int value = sim_pin_value(pin, now);
+            if (value != p->last_value) {
+                int rising = value == HIGH;
+                if ((rising && (p->edge & EDGE_RISING)) || (!rising && (p->edge & EDGE_FALLING))) {
+                    uint64_t one = 1;
+                    write(p->efd, &one, sizeof(one));
+                }
+                p->last_value = value;
+            }
+        }
+        pthread_mutex_unlock(&s_sim_mutex);
+        usleep(SIM_EDGE_TICK_US);
+    }
+    return NULL;
+}
+
+static int sim_gpio_export(int pin) {
+    if (!valid_pin(pin)) {
+        return -1;
+    }
+    pthread_mutex_lock(&s_sim_mutex);
+    s_pins[pin].exported = 1;
+    pthread_mutex_unlock(&s_sim_mutex);
+    return 0;
+}
+
+static int sim_gpio_unexport(int pin) {
+    if (!valid_pin(pin)) {
+        return -1;
+    }
+    pthread_mutex_lock(&s_sim_mutex);
+    s_pins[pin].exported = 0;
+    s_pins[pin].edge = EDGE_NONE;
+    pthread_mutex_unlock(&s_sim_mutex);
+    return 0;
+}
+
+static int sim_gpio_direction(int pin, int dir) {
+    if (!valid_pin(pin)) {
+        return -1;
+    }
+    pthread_mutex_lock(&s_sim_mutex);
+    s_pins[pin].dir = dir;
+    pthread_mutex_unlock(&s_sim_mutex);
+    return 0;
+}
+
+static int sim_gpio_read(int pin) {
+    int value;
+    if (!valid_pin(pin)) {
+        return -1;
+    }
+    long long now = sim_now_ns();
+    pthread_mutex_lock(&s_sim_mutex);
+    value = sim_pin_value(pin, now);
+    pthread_mutex_unlock(&s_sim_mutex);
+    return value;
+}
+
+// 라인 이벤트 큐에 edge 추가 (s_sim_mutex 잠긴 상태에서 호출)
+static void sim_line_push(int pin, uint64_t ts_ns, int rising) {
+    SimLine *line = &s_lines[pin];
+    if (!line->requested || line->count == SIM_LINE_QUEUE) {
+        return;
+    }
+    HalEdge *edge = &line->events[(line->head + line->count) % SIM_LINE_QUEUE];
+    edge->ts_ns = ts_ns;
+    edge->rising = rising;
+    line->count++;
+    pthread_cond_broadcast(&s_line_cond);
+}
+
+// TRIG 펄스에 대한 ECHO 라인 이벤트 생성 (s_sim_mutex 잠긴 상태에서 호출)
+static void sim_echo_events(long long now) {
+    // 가끔 에코가 돌아오지 않는 상황을 흉내냄
+    if (++s_trig_count % SIM_ECHO_DROP_EVERY == 0) {
+        return;
+    }
+    uint64_t rise = mono_ns() + SIM_ECHO_DELAY_US * 1000ULL;
+    uint64_t width = (uint64_t)(sim_distance_cm(now) * 2 / 34300.0 * 1e9);
+    sim_line_push(SIM_ECHO_PIN, rise, 1);
+    sim_line_push(SIM_ECHO_PIN, rise + width, 0);
+}
+
+// DHT 펄스 폭에 지터 추가 (ns)
+static uint64_t sim_dht_pulse_ns(int width_us) {
+    s_dht_seed = s_dht_seed * 1103515245 + 12345;
+    int jitter = (int)((s_dht_seed >> 16) % (2 * SIM_DHT_JITTER_US + 1)) - SIM_DHT_JITTER_US;
+    return (uint64_t)(width_us + jitter) * 1000ULL;
+}
+
+// 시작 신호에 대한 DHT11 응답 edge 생성 (s_sim_mutex 잠긴 상태에서 호출)
+static void sim_dht_events(long long now) {
+    long long sec = now / 1000000000LL;
+    int humid = 50 + (int)(sec / 20 % 10);
+    int temp_x10 = 240 + (int)(sec / 10 % 10);
+    unsigned char bytes[5] = { humid, 0, temp_x10 / 10, temp_x10 % 10, 0 };
+
+    s_dht_count++;
+    if (s_dht_count % SIM_DHT_SILENT_EVERY == 0) {
+        return;
+    }
+    bytes[4] = bytes[0] + bytes[1] + bytes[2] + bytes[3];
+    if (s_dht_count % SIM_DHT_CORRUPT_EVERY == 0) {
+        bytes[s_dht_count % 4] ^= 0x04;
+    }
+
+    // 응답: 80us LOW, 80us HIGH, 이후 비트마다 50us LOW + 26us(0) 또는 70us(1) HIGH
+    uint64_t t = mono_ns() + 30000ULL;
+    sim_line_push(SIM_DHT_PIN, t, 0);
+    t += sim_dht_pulse_ns(80);
+    sim_line_push(SIM_DHT_PIN, t, 1);
+    t += sim_dht_pulse_ns(80);
+    sim_line_push(SIM_DHT_PIN, t, 0);
+    for (int i = 0; i < 40; i++) {
+        int bit = (bytes[i / 8] >> (7 - i % 8)) & 1;
+        t += sim_dht_pulse_ns(50);
+        sim_line_push(SIM_DHT_PIN, t, 1);
+        t += sim_dht_pulse_ns(bit ? 70 : 26);
+        sim_line_push(SIM_DHT_PIN, t, 0);
+    }
+    // 마지막 50us LOW 후 라인 해제 (풀업)
+    t += sim_dht_pulse_ns(50);
+    sim_line_push(SIM_DHT_PIN, t, 1);
+}
+
+static int sim_gpio_write(int pin, int value) {
+    if (!valid_pin(pin)) {
+        return -1;
+    }
+    long long now = sim_now_ns();
+    pthread_mutex_lock(&s_sim_mutex);
+    // TRIG falling edge에서 초음파 측정 시작
+    if (pin == SIM_TRIG_PIN && s_pins[pin].value == HIGH && value == LOW) {
+        s_trig_ns = now;
+        sim_echo_events(now);
+    }
+    s_pins[pin].value = value == LOW ? LOW : HIGH;
+    pthread_mutex_unlock(&s_sim_mutex);
+    return 0;
+}
+
+static int sim_gpio_set_edge(int pin, const char *edge) {
+    pthread_t thread;
+    int mode = EDGE_NONE;
+
+    if (!valid_pin(pin)) {
+        return -1;
+    }
+    if (strcmp(edge, "rising") == 0) {
+        mode = EDGE_RISING;
+    } else if (strcmp(edge, "falling") == 0) {
+        mode = EDGE_FALLING;
+    } else if (strcmp(edge, "both") == 0) {
+        mode = EDGE_BOTH;
+    }
+
+    long long now = sim_now_ns();
+    pthread_mutex_lock(&s_sim_mutex);
+    if (s_pins[pin].efd == -1) {
+        s_pins[pin].efd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    }
+    s_pins[pin].edge = mode;
+    s_pins[pin].last_value = sim_pin_value(pin, now);
+    if (!s_edge_thread_started) {
+        if (pthread_create(&thread, NULL, sim_edge_thread, NULL) == 0) {
+            pthread_detach(thread);
+            s_edge_thread_started = 1;
+        }
+    }
+    pthread_mutex_unlock(&s_sim_mutex);
+    return s_pins[pin].efd == -1 ? -1 : 0;
+}
+
+static int sim_gpio_poll_fd(int pin, short *events) {
+    if (!valid_pin(pin)) {
+        return -1;
+    }
+    *events = POLLIN;
+    return s_pins[pin].efd;
+}
+
+static int sim_gpio_edge_ack(int pin) {
+    uint64_t count;
+    if (!valid_pin(pin)) {
+        return -1;
+    }
+    if (s_pins[pin].efd != -1) {
+        read(s_pins[pin].efd, &count, sizeof(count));
+    }
+    return sim_gpio_read(pin);
+}
+
+static int sim_gpio_line_request(int pin) {
+    if (!valid_pin(pin)) {
+        return -1;
+    }
+    pthread_mutex_lock(&s_sim_mutex);
+    s_lines[pin].requested = 1;
+    s_lines[pin].head = 0;
+    s_lines[pin].count = 0;
+    pthread_mutex_unlock(&s_sim_mutex);
+    return pin;
+}
+
+static int sim_gpio_line_read(int handle, HalEdge *edge, int timeout_ms) {
+    SimLine *line;
+    uint64_t deadline = mono_ns() + (uint64_t)timeout_ms * 1000000ULL;
+    int ret = 0;
+
+    if (!valid_pin(handle)) {
+        return -1;
+    }
+    line = &s_lines[handle];
+
+    pthread_mutex_lock(&s_sim_mutex);
+    while (1) {
+        uint64_t now = mono_ns();
+        uint64_t wake = deadline;
+
+        // 발생 시각이 지난 이벤트만 전달
+        if (line->count > 0) {
+            HalEdge *head = &line->events[line->head];
+            if (head->ts_ns <= now) {
+                *edge = *head;
+                line->head = (line->head + 1) % SIM_LINE_QUEUE;
+                line->count--;
+                ret = 1;
+                break;
+            }
+            if (head->ts_ns < wake) {
+                wake = head->ts_ns;
+            }
+        }
+        if (now >= deadline) {
+            break;
+        }
+
+        struct timespec ts = { .tv_sec = wake / 1000000000ULL, .tv_nsec = wake % 1000000000ULL };
+        pthread_cond_timedwait(&s_line_cond, &s_sim_mutex, &ts);
+    }
+    pthread_mutex_unlock(&s_sim_mutex);
+    return ret;
+}
+
+static void sim_gpio_line_release(int handle) {
+    if (!valid_pin(handle)) {
+        return;
+    }
+    pthread_mutex_lock(&s_sim_mutex);
+    s_lines[handle].requested = 0;
+    pthread_mutex_unlock(&s_sim_mutex);
+}
+
+static int sim_gpio_line_pulse(int handle, int low_us) {
+    struct timespec ts = { low_us / 1000000, (low_us % 1000000) * 1000L };
+
+    if (!valid_pin(handle)) {
+        return -1;
+    }
+    nanosleep(&ts, NULL);
+
+    long long now = sim_now_ns();
+    pthread_mutex_lock(&s_sim_mutex);
+    if (handle == SIM_DHT_PIN) {
+        sim_dht_events(now);
+    }
+    pthread_mutex_unlock(&s_sim_mutex);
+    return 0;
+}
+
+static int sim_pwm_export(int pwmnum) {
+    if (pwmnum < 0 || pwmnum > 1) {
+        errno = EINVAL;
+        return -1;
+    }
+    pthread_mutex_lock(&s_sim_mutex);
+    s_pwm[pwmnum].exported = 1;
+    pthread_mutex_unlock(&s_sim_mutex);
+    return 0;
+}
+
+static int sim_pwm_unexport(int pwmnum) {
+    if (pwmnum < 0 || pwmnum > 1) {
+        errno = EINVAL;
+        return -1;
+    }
+    pthread_mutex_lock(&s_sim_mutex);
+    memset(&s_pwm[pwmnum], 0, sizeof(SimPwm));
+    pthread_mutex_unlock(&s_sim_mutex);
+    return 0;
+}
+
+static int sim_pwm_write(int pwmnum, const char *attr, long value) {
+    if (pwmnum < 0 || pwmnum > 1 || !s_pwm[pwmnum].exported) {
+        errno = ENOENT;
+        return -1;
+    }
+    pthread_mutex_lock(&s_sim_mutex);
+    if (strcmp(attr, "period") == 0) {
+        s_pwm[pwmnum].period = value;
+    } else if (strcmp(attr, "duty_cycle") == 0) {
+        s_pwm[pwmnum].duty_cycle = value;
+    } else if (strcmp(attr, "enable") == 0) {
+        s_pwm[pwmnum].enable = value;
+    }
+    pthread_mutex_unlock(&s_sim_mutex);
+    return 0;
+}
+
+// 화면이 바뀌었으면 HOMEFARM_SIM_LCD_TRACE 설정 시 내용 출력
+static void sim_lcd_trace(void) {
+    if (s_lcd.dirty && getenv("HOMEFARM_SIM_LCD_TRACE") != NULL) {
+        fprintf(stderr, "[LCD] |%s|%s|\n", s_lcd.chars[0], s_lcd.chars[1]);
+    }
+    s_lcd.dirty = 0;
+}
+
+// HD44780 명령/데이터 1바이트 실행
+static void sim_lcd_exec(int rs, int byte) {
+    if (rs) {
+        // DDRAM 쓰기: 0x00 ~ 0x0F 첫째 줄, 0x40 ~ 0x4F 둘째 줄
+        int line = s_lcd.addr >= 0x40;
+        int col = s_lcd.addr - (line ? 0x40 : 0);
+        if (col >= 0 && col < SIM_LCD_COLS) {
+            s_lcd.chars[line][col] = (char)byte;
+            s_lcd.dirty = 1;
+        }
+        s_lcd.addr = (s_lcd.addr + 1) & 0x7F;
+    } else if (byte == 0x01) {
+        sim_lcd_trace();
+        memset(s_lcd.chars[0], ' ', SIM_LCD_COLS);
+        memset(s_lcd.chars[1], ' ', SIM_LCD_COLS);
+        s_lcd.addr = 0;
+    } else if (byte & 0x80) {
+        sim_lcd_trace();
+        s_lcd.addr = byte & 0x7F;
+    } else if ((byte & 0xFE) == 0x02) {
+        s_lcd.addr = 0;
+    }
+}
+
+// PCF8574 출력 바이트 한 개 처리, EN falling edge에서 니블 래치
+static void sim_lcd_feed(int b) {
+    if ((s_lcd.prev & SIM_LCD_EN) && !(b & SIM_LCD_EN)) {
+        int nibble = (s_lcd.prev >> 4) & 0x0F;
+        int rs = s_lcd.prev & SIM_LCD_RS;
+
+        if (s_lcd.mode8) {
+            // 8비트 모드에서는 상위 니블만으로 명령 실행, 0x2x 명령 시 4비트 모드 전환
+            if (nibble == 0x2) {
+                s_lcd.mode8 = 0;
+            }
+        } else if (!s_lcd.nibble_pending) {
+            s_lcd.high_nibble = nibble;
+            s_lcd.nibble_pending = 1;
+        } else {
+            s_lcd.nibble_pending = 0;
+            sim_lcd_exec(rs, (s_lcd.high_nibble << 4) | nibble);
+        }
+    }
+    s_lcd.prev = b;
+}
+
+static int sim_i2c_open(int bus, int addr) {
+    pthread_once(&s_sim_once, sim_init);
+    if (addr != SIM_LCD_ADDR) {
+        errno = ENXIO;
+        perror("Failed to acquire bus access and/or talk to slave");
+        return -1;
+    }
+    return addr;
+}
+
+static int sim_i2c_write(int handle, const unsigned char *buf, int len) {
+    if (handle != SIM_LCD_ADDR) {
+        errno = EBADF;
+        return -1;
+    }
+    pthread_mutex_lock(&s_sim_mutex);
+    if (s_i2c_faults > 0) {
+        // 버스 오류 : 전송 실패, LCD는 전원이 다시 들어온 상태가 됨
+        s_i2c_faults--;
+        sim_lcd_reset();
+        pthread_mutex_unlock(&s_sim_mutex);
+        errno = EIO;
+        return -1;
+    }
+    s_i2c_writes++;
+    s_i2c_bytes += len;
+    for (int i = 0; i < len; i++) {
+        sim_lcd_feed(buf[i]);
+    }
+    pthread_mutex_unlock(&s_sim_mutex);
+    return len;
+}
+
+static void sim_i2c_close(int handle) {
+}
+
+void hal_sim_lcd_snapshot(char line1[17], char line2[17]) {
+    pthread_once(&s_sim_once, sim_init);
+    pthread_mutex_lock(&s_sim_mutex);
+    memcpy(line1, s_lcd.chars[0], SIM_LCD_COLS + 1);
+    memcpy(line2, s_lcd.chars[1], SIM_LCD_COLS + 1);
+    pthread_mutex_unlock(&s_sim_mutex);
+}
+
+void hal_sim_i2c_stats(long *writes, long *bytes) {
+    pthread_once(&s_sim_once, sim_init);
+    pthread_mutex_lock(&s_sim_mutex);
+    *writes = s_i2c_writes;
+    *bytes = s_i2c_bytes;
+    pthread_mutex_unlock(&s_sim_mutex);
+}
+
+void hal_sim_i2c_fault(int writes) {
+    pthread_once(&s_sim_once, sim_init);
+    pthread_mutex_lock(&s_sim_mutex);
+    s_i2c_faults = writes;
+    pthread_mutex_unlock(&s_sim_mutex);
+}
+
+const HalOps hal_sim_ops = {
+    .name = "sim",
+    .gpio_export = sim_gpio_export,
+    .gpio_unexport = sim_gpio_unexport,
+    .gpio_direction = sim_gpio_direction,
+    .gpio_read = sim_gpio_read,
+    .gpio_write = sim_gpio_write,
+    .gpio_set_edge = sim_gpio_set_edge,
+    .gpio_poll_fd = sim_gpio_poll_fd,
+    .gpio_edge_ack = sim_gpio_edge_ack,
+    .gpio_line_request = sim_gpio_line_request,
+    .gpio_line_read = sim_gpio_line_read,
+    .gpio_line_release = sim_gpio_line_release,
+    .gpio_line_pulse = sim_gpio_line_pulse,
+    .pwm_export = sim_pwm_export,
+    .pwm_unexport = sim_pwm_unexport,
+    .pwm_write = sim_pwm_write,
+    .i2c_open = sim_i2c_open,
+    .i2c_write = sim_i2c_write,
+    .i2c_close = sim_i2c_close,
+};
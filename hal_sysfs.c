@@ -0,0 +1,474 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <string.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <time.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <sys/ioctl.h>
+#include <sys/inotify.h>
+#include <linux/i2c-dev.h>
+#include <linux/gpio.h>
+
+#include "gpio.h"
+#include "hal.h"
+
+/***************************************************************************
+ * 실제 보드용 HAL 백엔드
+ * /sys/class/gpio, /sys/class/pwm/pwmchip0, /dev/i2c-N 사용
+ ***************************************************************************/
+
+#define PATH_LEN 128
+#define PWM_ROOT "/sys/class/pwm/pwmchip0"
+#define GPIO_CHIP "/dev/gpiochip0"
+#define LINE_EVENT_FLAGS (GPIO_V2_LINE_FLAG_INPUT | GPIO_V2_LINE_FLAG_EDGE_RISING | \
+                          GPIO_V2_LINE_FLAG_EDGE_FALLING)
+#define PWM_CHANNEL_MAX 2
+#define PWM_ATTR_COUNT 3           // period, duty_cycle, enable
+#define PWM_EXPORT_TIMEOUT_MS 1000 // export 후 채널 속성 파일이 준비되기까지 기다릴 최대 시간
+#define PWM_RECHECK_MS 10          // inotify 알림이 없어도 다시 확인하는 간격
+#define LINE_EVENT_BUFFER 128 // DHT 응답 한 번(약 84개 edge)을 담을 수 있는 커널 이벤트 버퍼
+
+// sysfs GPIO 루트 경로
+static char s_sysfs_root[PATH_LEN / 2] = "/sys/class/gpio";
+
+// 핀별로 열어둔 value, direction 파일 디스크립터 (-1 = 열리지 않음)
+// 핀을 unexport 할 때까지 유지하여 매 호출마다 open/close 하지 않도록 함
+// 바꾸는 것은 s_fd_mutex 안에서만, 읽기는 잠그지 않으므로 atomic (release로 저장, acquire로 읽음)
+static _Atomic int s_value_fd[GPIO_PIN_MAX];
+static _Atomic int s_direction_fd[GPIO_PIN_MAX];
+static _Atomic int s_fd_table_ready = 0;
+
+// PWM 채널별로 열어둔 period, duty_cycle, enable 디스크립터 (-1 = 열리지 않음)
+static const char *s_pwm_attrs[] = { "period", "duty_cycle", "enable" };
+static int s_pwm_fd[PWM_CHANNEL_MAX][PWM_ATTR_COUNT];
+static pthread_mutex_t s_fd_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+// 파일 디스크립터 테이블 초기화 (s_fd_mutex 잠긴 상태에서 호출)
+static void fd_table_init(void) {
+    if (s_fd_table_ready) {
+        return;
+    }
+    for (int i = 0; i < GPIO_PIN_MAX; i++) {
+        atomic_store_explicit(&s_value_fd[i], -1, memory_order_relaxed);
+        atomic_store_explicit(&s_direction_fd[i], -1, memory_order_relaxed);
+    }
+    for (int i = 0; i < PWM_CHANNEL_MAX; i++) {
+        for (int j = 0; j < PWM_ATTR_COUNT; j++) {
+            s_pwm_fd[i][j] = -1;
+        }
+    }
+    atomic_store_explicit(&s_fd_table_ready, 1, memory_order_release);
+}
+
+// 핀의 attr 파일(value, direction)을 열어서 캐시에 저장하고 디스크립터 반환
+static int cached_fd(_Atomic int *table, int pin, const char *attr) {
+    char path[PATH_LEN]; // 경로 버퍼
+    int fd;
+
+    if (pin < 0 || pin >= GPIO_PIN_MAX) {
+        fprintf(stderr, "Invalid gpio pin %d!\n", pin);
+        return -1;
+    }
+
+    // 이미 열려있는 경우 잠그지 않고 바로 반환
+    if (atomic_load_explicit(&s_fd_table_ready, memory_order_acquire)) {
+        fd = atomic_load_explicit(&table[pin], memory_order_acquire);
+        if (fd != -1) {
+            return fd;
+        }
+    }
+
+    pthread_mutex_lock(&s_fd_mutex);
+    fd_table_init();
+    fd = atomic_load_explicit(&table[pin], memory_order_relaxed);
+    if (fd == -1) {
+        snprintf(path, PATH_LEN, "%s/gpio%d/%s", s_sysfs_root, pin, attr);
+        fd = open(path, O_RDWR | O_CLOEXEC);
+        atomic_store_explicit(&table[pin], fd, memory_order_release);
+    }
+    pthread_mutex_unlock(&s_fd_mutex);
+    return fd;
+}
+
+// 핀에 대해 캐시된 디스크립터 모두 닫기
+static void close_cached_fds(int pin) {
+    if (pin < 0 || pin >= GPIO_PIN_MAX) {
+        return;
+    }
+
+    pthread_mutex_lock(&s_fd_mutex);
+    fd_table_init();
+    // 다른 스레드가 더 이상 가져가지 않도록 먼저 -1로 바꾼 뒤 닫음
+    int value_fd = atomic_exchange_explicit(&s_value_fd[pin], -1, memory_order_acq_rel);
+    int direction_fd = atomic_exchange_explicit(&s_direction_fd[pin], -1, memory_order_acq_rel);
+    if (value_fd != -1) {
+        close(value_fd);
+    }
+    if (direction_fd != -1) {
+        close(direction_fd);
+    }
+    pthread_mutex_unlock(&s_fd_mutex);
+}
+
+// 파일에 문자열 한 번 쓰기 (export, unexport, edge 등 가끔 쓰는 속성용)
+static int write_once(const char *path, const char *str) {
+    int fd = open(path, O_WRONLY | O_CLOEXEC);
+    if (fd == -1) {
+        // 파일 열기 실패 시 오류 메시지 출력
+        fprintf(stderr, "Failed to open %s for writing!\n", path);
+        return -1;
+    }
+    if (write(fd, str, strlen(str)) == -1) {
+        fprintf(stderr, "Failed to write %s!\n", path);
+        close(fd);
+        return -1;
+    }
+    close(fd); // 파일 디스크립터 닫기
+    return 0;
+}
+
+// export, unexport 파일에 번호 쓰기
+static int write_number(const char *root, const char *file, int num) {
+    char path[PATH_LEN]; // 경로 버퍼
+    char buffer[3]; // 번호를 저장할 버퍼
+
+    snprintf(path, PATH_LEN, "%s/%s", root, file);
+    snprintf(buffer, 3, "%d", num);
+    return write_once(path, buffer);
+}
+
+void hal_sysfs_set_root(const char *root) {
+    snprintf(s_sysfs_root, sizeof(s_sysfs_root), "%s", root);
+}
+
+static int sysfs_gpio_export(int pin) {
+    return write_number(s_sysfs_root, "export", pin);
+}
+
+static int sysfs_gpio_unexport(int pin) {
+    // 핀이 사라지기 전에 캐시된 디스크립터 정리
+    close_cached_fds(pin);
+    return write_number(s_sysfs_root, "unexport", pin);
+}
+
+static int sysfs_gpio_direction(int pin, int dir) {
+    static const char s_directions_str[] = "in\0out"; // 방향 문자열
+    int fd = cached_fd(s_direction_fd, pin, "direction");
+    if (fd == -1) {
+        // 파일 열기 실패 시 오류 메시지 출력
+        fprintf(stderr, "Failed to open gpio direction for writing!\n");
+        return -1;
+    }
+
+    // 방향 설정 (입력 또는 출력)
+    if (pwrite(fd, &s_directions_str[IN == dir ? 0 : 3], IN == dir ? 2 : 3, 0) == -1) {
+        fprintf(stderr, "Failed to set direction!\n");
+        return -1;
+    }
+    return 0; // 성공적으로 방향 설정 완료
+}
+
+static int sysfs_gpio_read(int pin) {
+    char value_str[3]; // 값 문자열 버퍼
+    ssize_t n;
+    int fd = cached_fd(s_value_fd, pin, "value");
+    if (fd == -1) {
+        // 파일 열기 실패 시 오류 메시지 출력
+        fprintf(stderr, "Failed to open gpio value for reading!\n");
+        return -1;
+    }
+
+    // sysfs 속성은 offset 0부터 다시 읽어야 최신 값이 나오므로 pread 사용
+    n = pread(fd, value_str, sizeof(value_str) - 1, 0);
+    if (n <= 0) {
+        // 값 읽기 실패 시 오류 메시지 출력
+        fprintf(stderr, "Failed to read value!\n");
+        return -1;
+    }
+    value_str[n] = '\0';
+    return atoi(value_str); // 값을 정수로 변환하여 반환
+}
+
+static int sysfs_gpio_write(int pin, int value) {
+    static const char s_values_str[] = "01"; // 값 문자열
+    int fd = cached_fd(s_value_fd, pin, "value");
+    if (fd == -1) {
+        // 파일 열기 실패 시 오류 메시지 출력
+        fprintf(stderr, "Failed to open gpio value for writing!\n");
+        return -1;
+    }
+
+    // 값 쓰기
+    if (pwrite(fd, &s_values_str[LOW == value ? 0 : 1], 1, 0) != 1) {
+        // 값 쓰기 실패 시 오류 메시지 출력
+        fprintf(stderr, "Failed to write value!\n");
+        return -1;
+    }
+    return 0; // 성공적으로 값 쓰기 완료
+}
+
+static int sysfs_gpio_set_edge(int pin, const char *edge) {
+    char path[PATH_LEN]; // 경로 버퍼
+
+    // edge는 설정할 때만 쓰므로 캐시하지 않음
+    snprintf(path, PATH_LEN, "%s/gpio%d/edge", s_sysfs_root, pin);
+    return write_once(path, edge);
+}
+
+static int sysfs_gpio_poll_fd(int pin, short *events) {
+    // sysfs value 파일은 edge 발생 시 POLLPRI로 깨어남
+    *events = POLLPRI | POLLERR;
+    return cached_fd(s_value_fd, pin, "value");
+}
+
+static int sysfs_gpio_edge_ack(int pin) {
+    // value를 다시 읽어야 대기 중인 edge 알림이 해제됨
+    return sysfs_gpio_read(pin);
+}
+
+static int sysfs_gpio_line_request(int pin) {
+    struct gpio_v2_line_request req;
+    int chip_fd;
+
+    chip_fd = open(GPIO_CHIP, O_RDONLY | O_CLOEXEC);
+    if (chip_fd == -1) {
+        perror("Failed to open " GPIO_CHIP);
+        return -1;
+    }
+
+    // 입력 라인의 양쪽 edge를 커널 타임스탬프와 함께 요청
+    memset(&req, 0, sizeof(req));
+    req.offsets[0] = pin;
+    req.num_lines = 1;
+    req.config.flags = LINE_EVENT_FLAGS;
+    req.event_buffer_size = LINE_EVENT_BUFFER;
+    snprintf(req.consumer, sizeof(req.consumer), "homefarm");
+    if (ioctl(chip_fd, GPIO_V2_GET_LINE_IOCTL, &req) == -1) {
+        perror("Failed to request gpio line events");
+        close(chip_fd);
+        return -1;
+    }
+    close(chip_fd); // 라인 fd는 칩 fd와 별개로 유지됨
+    return req.fd;
+}
+
+static int sysfs_gpio_line_read(int handle, HalEdge *edge, int timeout_ms) {
+    struct gpio_v2_line_event event;
+    struct pollfd pfd = { .fd = handle, .events = POLLIN };
+    int ret = poll(&pfd, 1, timeout_ms);
+
+    if (ret <= 0) {
+        return ret;
+    }
+    if (read(handle, &event, sizeof(event)) != sizeof(event)) {
+        return -1;
+    }
+    edge->ts_ns = event.timestamp_ns;
+    edge->rising = event.id == GPIO_V2_LINE_EVENT_RISING_EDGE;
+    return 1;
+}
+
+static void sysfs_gpio_line_release(int handle) {
+    close(handle);
+}
+
+static int sysfs_gpio_line_pulse(int handle, int low_us) {
+    struct gpio_v2_line_config config;
+    struct timespec ts = { low_us / 1000000, (low_us % 1000000) * 1000L };
+
+    // 출력으로 바꾸면서 초기값 LOW 지정
+    memset(&config, 0, sizeof(config));
+    config.flags = GPIO_V2_LINE_FLAG_OUTPUT;
+    config.num_attrs = 1;
+    config.attrs[0].attr.id = GPIO_V2_LINE_ATTR_ID_OUTPUT_VALUES;
+    config.attrs[0].attr.values = 0;
+    config.attrs[0].mask = 1;
+    if (ioctl(handle, GPIO_V2_LINE_SET_CONFIG_IOCTL, &config) == -1) {
+        perror("Failed to drive gpio line low");
+        return -1;
+    }
+    nanosleep(&ts, NULL);
+
+    // 입력으로 되돌려 센서 응답 edge를 기록
+    memset(&config, 0, sizeof(config));
+    config.flags = LINE_EVENT_FLAGS;
+    if (ioctl(handle, GPIO_V2_LINE_SET_CONFIG_IOCTL, &config) == -1) {
+        perror("Failed to release gpio line");
+        return -1;
+    }
+    return 0;
+}
+
+// path가 쓰기 가능해질 때까지 dir을 inotify로 감시하며 기다림
+// sysfs는 커널이 만든 파일에 대해 IN_CREATE를 보내지 않을 수 있어서
+// (udev가 권한을 바꿀 때의 IN_ATTRIB만 옴) 짧은 간격으로 다시 확인함
+static int wait_writable(const char *dir, const char *path, int timeout_ms) {
+    struct timespec start, now;
+    char events[512];
+    int ifd, elapsed = 0;
+
+    ifd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (ifd != -1) {
+        inotify_add_watch(ifd, dir, IN_CREATE | IN_ATTRIB);
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    while (access(path, W_OK) == -1 && elapsed < timeout_ms) {
+        if (ifd == -1) {
+            usleep(PWM_RECHECK_MS * 1000);
+        } else {
+            struct pollfd pfd = { .fd = ifd, .events = POLLIN };
+            if (poll(&pfd, 1, PWM_RECHECK_MS) > 0) {
+                while (read(ifd, events, sizeof(events)) > 0) {
+                }
+            }
+        }
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        elapsed = (now.tv_sec - start.tv_sec) * 1000 + (now.tv_nsec - start.tv_nsec) / 1000000;
+    }
+
+    if (ifd != -1) {
+        close(ifd);
+    }
+    return access(path, W_OK);
+}
+
+// 채널의 캐시된 속성 디스크립터 모두 닫기
+static void close_pwm_fds(int pwmnum) {
+    pthread_mutex_lock(&s_fd_mutex);
+    fd_table_init();
+    for (int i = 0; i < PWM_ATTR_COUNT; i++) {
+        if (s_pwm_fd[pwmnum][i] != -1) {
+            close(s_pwm_fd[pwmnum][i]);
+            s_pwm_fd[pwmnum][i] = -1;
+        }
+    }
+    pthread_mutex_unlock(&s_fd_mutex);
+}
+
+static int sysfs_pwm_export(int pwmnum) {
+    char dir[PATH_LEN / 2]; // 채널 디렉터리
+    char path[PATH_LEN]; // 준비 여부를 확인할 속성 파일
+
+    if (pwmnum < 0 || pwmnum >= PWM_CHANNEL_MAX) {
+        fprintf(stderr, "Invalid pwm channel %d!\n", pwmnum);
+        return -1;
+    }
+    snprintf(dir, sizeof(dir), "%s/pwm%d", PWM_ROOT, pwmnum);
+    snprintf(path, PATH_LEN, "%s/period", dir);
+
+    // 이전 실행에서 이미 내보낸 채널이면 그대로 사용
+    if (access(path, W_OK) == 0) {
+        return 0;
+    }
+    if (write_number(PWM_ROOT, "export", pwmnum) == -1) {
+        return -1;
+    }
+
+    // 채널 디렉터리가 생기고 속성 파일 권한이 설정될 때까지 대기
+    if (wait_writable(PWM_ROOT, dir, PWM_EXPORT_TIMEOUT_MS) == -1 ||
+        wait_writable(dir, path, PWM_EXPORT_TIMEOUT_MS) == -1) {
+        fprintf(stderr, "Timed out waiting for %s!\n", dir);
+        return -1;
+    }
+    return 0; // 성공적으로 내보내기 완료
+}
+
+static int sysfs_pwm_unexport(int pwmnum) {
+    if (pwmnum < 0 || pwmnum >= PWM_CHANNEL_MAX) {
+        fprintf(stderr, "Invalid pwm channel %d!\n", pwmnum);
+        return -1;
+    }
+    // 채널이 사라지기 전에 캐시된 디스크립터 정리
+    close_pwm_fds(pwmnum);
+    return write_number(PWM_ROOT, "unexport", pwmnum);
+}
+
+static int sysfs_pwm_write(int pwmnum, const char *attr, long value) {
+    char path[PATH_LEN]; // 경로 버퍼
+    char s_value_str[24]; // 값 문자열 버퍼
+    int len, fd = -1;
+
+    if (pwmnum < 0 || pwmnum >= PWM_CHANNEL_MAX) {
+        fprintf(stderr, "Invalid pwm channel %d!\n", pwmnum);
+        return -1;
+    }
+    len = snprintf(s_value_str, sizeof(s_value_str), "%ld", value);
+
+    // 자주 쓰는 속성은 열어둔 디스크립터 재사용
+    for (int i = 0; i < PWM_ATTR_COUNT; i++) {
+        if (strcmp(attr, s_pwm_attrs[i]) != 0) {
+            continue;
+        }
+        pthread_mutex_lock(&s_fd_mutex);
+        fd_table_init();
+        if (s_pwm_fd[pwmnum][i] == -1) {
+            // PWM 속성 파일 경로 설정
+            snprintf(path, PATH_LEN, "%s/pwm%d/%s", PWM_ROOT, pwmnum, attr);
+            s_pwm_fd[pwmnum][i] = open(path, O_WRONLY | O_CLOEXEC);
+        }
+        fd = s_pwm_fd[pwmnum][i];
+        pthread_mutex_unlock(&s_fd_mutex);
+        break;
+    }
+    if (fd == -1) {
+        snprintf(path, PATH_LEN, "%s/pwm%d/%s", PWM_ROOT, pwmnum, attr);
+        return write_once(path, s_value_str);
+    }
+
+    if (pwrite(fd, s_value_str, len, 0) != len) {
+        fprintf(stderr, "Failed to write pwm%d/%s!\n", pwmnum, attr);
+        return -1;
+    }
+    return 0;
+}
+
+static int sysfs_i2c_open(int bus, int addr) {
+    char path[PATH_LEN];
+    int fd;
+
+    snprintf(path, PATH_LEN, "/dev/i2c-%d", bus);
+    if ((fd = open(path, O_RDWR | O_CLOEXEC)) < 0) { // I2C 버스를 열기
+        perror("Failed to open i2c bus");
+        return -1;
+    }
+    if (ioctl(fd, I2C_SLAVE, addr) < 0) { // I2C 장치 설정
+        perror("Failed to acquire bus access and/or talk to slave");
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+static int sysfs_i2c_write(int handle, const unsigned char *buf, int len) {
+    return write(handle, buf, len);
+}
+
+static void sysfs_i2c_close(int handle) {
+    close(handle);
+}
+
+const HalOps hal_sysfs_ops = {
+    .name = "sysfs",
+    .gpio_export = sysfs_gpio_export,
+    .gpio_unexport = sysfs_gpio_unexport,
+    .gpio_direction = sysfs_gpio_direction,
+    .gpio_read = sysfs_gpio_read,
+    .gpio_write = sysfs_gpio_write,
+    .gpio_set_edge = sysfs_gpio_set_edge,
+    .gpio_poll_fd = sysfs_gpio_poll_fd,
+    .gpio_edge_ack = sysfs_gpio_edge_ack,
+    .gpio_line_request = sysfs_gpio_line_request,
+    .gpio_line_read = sysfs_gpio_line_read,
+    .gpio_line_release = sysfs_gpio_line_release,
+    .gpio_line_pulse = sysfs_gpio_line_pulse,
+    .pwm_export = sysfs_pwm_export,
+    .pwm_unexport = sysfs_pwm_unexport,
+    .pwm_write = sysfs_pwm_write,
+    .i2c_open = sysfs_i2c_open,
+    .i2c_write = sysfs_i2c_write,
+    .i2c_close = sysfs_i2c_close,
+};
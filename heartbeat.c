@@ -0,0 +1,147 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+
+#include "heartbeat.h"
+
+#define RTT_FIRST_BUCKET_US 64
+#define PING_LEN 8
+
+void heartbeat_config(int *interval_ms, int *misses) {
+    const char *interval_env = getenv("HOMEFARM_HEARTBEAT_MS");
+    const char *misses_env = getenv("HOMEFARM_HEARTBEAT_MISSES");
+
+    *interval_ms = interval_env ? atoi(interval_env) : HEARTBEAT_INTERVAL_MS;
+    *misses = misses_env ? atoi(misses_env) : HEARTBEAT_MISSES;
+    if (*interval_ms < 100) {
+        *interval_ms = 100;
+    }
+    if (*misses < 1) {
+        *misses = 1;
+    }
+}
+
+void heartbeat_tune_socket(int fd, int interval_ms, int misses) {
+    int on = 1;
+    int interval_sec = interval_ms < 1000 ? 1 : interval_ms / 1000;
+    unsigned int user_timeout = interval_ms * misses;
+
+    setsockopt(fd, SOL_SOCKET, SO_KEEPALIVE, &on, sizeof(on));
+    setsockopt(fd, IPPROTO_TCP, TCP_KEEPIDLE, &interval_sec, sizeof(interval_sec));
+    setsockopt(fd, IPPROTO_TCP, TCP_KEEPINTVL, &interval_sec, sizeof(interval_sec));
+    setsockopt(fd, IPPROTO_TCP, TCP_KEEPCNT, &misses, sizeof(misses));
+    setsockopt(fd, IPPROTO_TCP, TCP_USER_TIMEOUT, &user_timeout, sizeof(user_timeout));
+    // 작은 메시지를 바로 보냄 (PONG의 ACK가 늦게 오는 동안 Nagle이 다음 메시지를 최대 40ms 붙잡음)
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &on, sizeof(on));
+}
+
+// CLOCK_MONOTONIC 기준 현재 시각 (us)
+static long long now_us(void) {
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000000LL + ts.tv_nsec / 1000;
+}
+
+int heartbeat_ping(ProtoConn *conn, Heartbeat *hb) {
+    long long sent = now_us();
+    unsigned int payload[2] = { htonl((unsigned int)(sent >> 32)), htonl((unsigned int)sent) };
+
+    hb->missed++;
+    return proto_send(conn, PROTO_PING, payload, PING_LEN);
+}
+
+int heartbeat_pong(ProtoConn *conn, const ProtoMsg *ping) {
+    return proto_send(conn, PROTO_PONG, ping->payload, ping->length);
+}
+
+// RTT가 들어갈 칸 번호
+static int rtt_bucket(long rtt_us) {
+    int bucket = 0;
+    long limit = RTT_FIRST_BUCKET_US;
+
+    while (rtt_us >= limit && bucket < RTT_BUCKETS - 1) {
+        limit *= 2;
+        bucket++;
+    }
+    return bucket;
+}
+
+int heartbeat_receive(Heartbeat *hb, const ProtoMsg *pong) {
+    unsigned int payload[2];
+    long long sent;
+    int bucket;
+
+    if (pong->length != PING_LEN) {
+        return -1;
+    }
+    memcpy(payload, pong->payload, PING_LEN);
+    sent = ((long long)ntohl(payload[0]) << 32) | ntohl(payload[1]);
+
+    hb->missed = 0;
+    hb->last_us = (long)(now_us() - sent);
+    bucket = rtt_bucket(hb->last_us);
+
+    // 가장 오래된 RTT를 분포에서 빼고 새 값으로 바꿈
+    if (hb->count == RTT_WINDOW) {
+        hb->buckets[hb->window[hb->next]]--;
+    } else {
+        hb->count++;
+    }
+    hb->window[hb->next] = bucket;
+    hb->buckets[bucket]++;
+    hb->next = (hb->next + 1) % RTT_WINDOW;
+    return 0;
+}
+
+long heartbeat_percentile(const Heartbeat *hb, int pct) {
+    int target = (hb->count * pct + 99) / 100;
+    int seen = 0;
+
+    if (hb->count == 0) {
+        return -1;
+    }
+    for (int i = 0; i < RTT_BUCKETS - 1; i++) {
+        seen += hb->buckets[i];
+        if (seen >= target) {
+            return (long)RTT_FIRST_BUCKET_US << i;
+        }
+    }
+    return -1; // 마지막 칸은 상한이 없음
+}
+
+// 백분위 값을 "< 상한 us" 또는 ">= RTT_OVERFLOW_US us" 로
+static const char *percentile_str(const Heartbeat *hb, int pct, char *buf, int size) {
+    long limit = heartbeat_percentile(hb, pct);
+
+    if (limit == -1) {
+        snprintf(buf, size, ">= %ld us", RTT_OVERFLOW_US);
+    } else {
+        snprintf(buf, size, "< %ld us", limit);
+    }
+    return buf;
+}
+
+void heartbeat_print(const Heartbeat *hb, const char *name) {
+    char p50[32], p99[32];
+
+    if (hb->count == 0) {
+        printf("%s : no RTT samples\n", name);
+        return;
+    }
+    printf("%s : RTT last %ld us, p50 %s, p99 %s (%d samples)\n", name, hb->last_us,
+           percentile_str(hb, 50, p50, sizeof(p50)), percentile_str(hb, 99, p99, sizeof(p99)), hb->count);
+    for (int i = 0; i < RTT_BUCKETS - 1; i++) {
+        if (hb->buckets[i] > 0) {
+            printf("  <  %7ld us : %d\n", (long)RTT_FIRST_BUCKET_US << i, hb->buckets[i]);
+        }
+    }
+    if (hb->buckets[RTT_BUCKETS - 1] > 0) {
+        printf("  >= %7ld us : %d\n", RTT_OVERFLOW_US, hb->buckets[RTT_BUCKETS - 1]);
+    }
+}
@@ -0,0 +1,60 @@
+#ifndef HEARTBEAT_H
+#define HEARTBEAT_H
+
+#include "proto.h"
+
+#define HEARTBEAT_INTERVAL_MS 2000  // 기본 heartbeat 간격 (HOMEFARM_HEARTBEAT_MS)
+#define HEARTBEAT_MISSES 3          // 기본 연속으로 놓쳐도 되는 heartbeat 수 (HOMEFARM_HEARTBEAT_MISSES)
+
+#define RTT_BUCKETS 16   // k번째 칸 = 2^(k+6) us 미만 (64us ~ 약 1초, 마지막 칸은 RTT_OVERFLOW_US 이상 전부)
+#define RTT_OVERFLOW_US (64L << (RTT_BUCKETS - 2)) // 마지막 칸의 하한 (1048576us, 약 1.05초)
+#define RTT_WINDOW 64    // 최근 몇 개의 RTT로 분포를 만들지
+
+/***************************************************************************
+ * 연결 하나의 heartbeat 상태
+ * 허브가 interval마다 PROTO_PING(보낸 시각)을 보내고 노드는 같은 내용으로 PROTO_PONG 응답
+ * 응답이 misses번 연속으로 오지 않으면 노드가 꺼진 것으로 봄
+ * RTT는 최근 RTT_WINDOW개만 분포(histogram)에 남김
+ ***************************************************************************/
+typedef struct {
+    int missed;                          // 응답 없이 보낸 PING 수
+    unsigned char window[RTT_WINDOW];    // 최근 RTT의 칸 번호 (오래된 것부터 지움)
+    int count;                           // window에 있는 RTT 수
+    int next;                            // window에서 다음에 쓸 위치
+    int buckets[RTT_BUCKETS];            // window 안의 칸별 RTT 수
+    long last_us;                        // 마지막 RTT
+} Heartbeat;
+
+// heartbeat 간격, 허용 횟수 (환경변수가 없으면 기본값)
+void heartbeat_config(int *interval_ms, int *misses);
+
+/***************************************************************************
+ * heartbeat_tune_socket(int fd, int interval_ms, int misses)
+ * 커널 쪽 연결 감시 설정
+ * TCP keepalive : 보내는 것이 없어도 interval마다 확인, misses번 응답이 없으면 끊음
+ * TCP_USER_TIMEOUT : 보낸 데이터가 interval * misses 동안 확인되지 않으면 끊음
+ * (전원이 나간 노드로 send가 계속 쌓이는 것을 막음)
+ * TCP_NODELAY : 메시지는 이미 한 번에 보내거나 대기열에서 모아 보내므로 Nagle로 기다리지 않음
+ ***************************************************************************/
+void heartbeat_tune_socket(int fd, int interval_ms, int misses);
+
+// PING 전송 (응답을 기다리는 수 증가), -1 = 전송 실패
+int heartbeat_ping(ProtoConn *conn, Heartbeat *hb);
+
+// 노드 쪽 : 받은 PING에 그대로 응답
+int heartbeat_pong(ProtoConn *conn, const ProtoMsg *ping);
+
+// PONG 수신 (RTT 기록), -1 = 잘못된 메시지
+int heartbeat_receive(Heartbeat *hb, const ProtoMsg *pong);
+
+/***************************************************************************
+ * heartbeat_percentile(const Heartbeat *hb, int pct)
+ * 최근 RTT 중 pct 퍼센트가 이 값(us) 미만 (칸의 상한)
+ * 기록이 없거나 마지막 칸(RTT_OVERFLOW_US 이상, 상한 없음)에 걸리면 -1
+ ***************************************************************************/
+long heartbeat_percentile(const Heartbeat *hb, int pct);
+
+// RTT 분포 출력
+void heartbeat_print(const Heartbeat *hb, const char *name);
+
+#endif
@@ -0,0 +1,15 @@
+#include "i2c.h"
+#include "hal.h"
+
+// I2C 접근은 모두 현재 HAL 백엔드로 전달
+int I2COpen(int bus, int addr) {
+    return hal()->i2c_open(bus, addr);
+}
+
+int I2CWrite(int handle, const unsigned char *buf, int len) {
+    return hal()->i2c_write(handle, buf, len);
+}
+
+void I2CClose(int handle) {
+    hal()->i2c_close(handle);
+}
@@ -0,0 +1,13 @@
+#ifndef I2C_H
+#define I2C_H
+
+// I2C 버스의 장치 열기, 실패 시 -1 반환
+int I2COpen(int bus, int addr);
+
+// I2C 장치에 바이트 쓰기, 쓰여진 바이트 수 반환
+int I2CWrite(int handle, const unsigned char *buf, int len);
+
+// I2C 장치 닫기
+void I2CClose(int handle);
+
+#endif
@@ -0,0 +1,80 @@
+#include <stdio.h>
+#include <poll.h>
+#include <time.h>
+
+#include "gpio.h"
+#include "input.h"
+
+// 등록된 입력 핀 정보
+typedef struct {
+    int pin;
+    int debounce_ms;
+    InputCallback cb;
+    void *arg;
+    struct timespec last; // 마지막으로 전달한 이벤트 시각
+} InputSource;
+
+static InputSource s_sources[INPUT_MAX];
+static int s_source_count = 0;
+
+// 두 시각의 차이를 ms 단위로 반환
+static long elapsed_ms(const struct timespec *from, const struct timespec *to) {
+    return (to->tv_sec - from->tv_sec) * 1000 + (to->tv_nsec - from->tv_nsec) / 1000000;
+}
+
+int input_register(int pin, const char *edge, int debounce_ms, InputCallback cb, void *arg) {
+    if (s_source_count >= INPUT_MAX) {
+        fprintf(stderr, "Too many input pins!\n");
+        return -1;
+    }
+    short events;
+    if (GPIOSetEdge(pin, edge) == -1 || GPIOPollFd(pin, &events) == -1) {
+        return -1;
+    }
+
+    InputSource *src = &s_sources[s_source_count++];
+    src->pin = pin;
+    src->debounce_ms = debounce_ms;
+    src->cb = cb;
+    src->arg = arg;
+    src->last.tv_sec = 0;
+    src->last.tv_nsec = 0;
+    return 0;
+}
+
+void input_loop(void) {
+    struct pollfd fds[INPUT_MAX];
+    int count = s_source_count;
+
+    for (int i = 0; i < count; i++) {
+        fds[i].fd = GPIOPollFd(s_sources[i].pin, &fds[i].events);
+        GPIOEdgeAck(s_sources[i].pin); // 등록 전에 쌓인 알림 제거
+    }
+
+    while (1) {
+        // edge가 발생할 때까지 잠듦 (poll은 스레드 cancel 지점)
+        if (poll(fds, count, -1) < 0) {
+            perror("input poll");
+            continue;
+        }
+
+        for (int i = 0; i < count; i++) {
+            if (!(fds[i].revents & fds[i].events)) {
+                continue;
+            }
+
+            InputSource *src = &s_sources[i];
+            InputEvent event;
+            clock_gettime(CLOCK_MONOTONIC, &event.ts);
+            event.pin = src->pin;
+            event.value = GPIOEdgeAck(src->pin);
+
+            // 채터링 제거
+            if (elapsed_ms(&src->last, &event.ts) < src->debounce_ms) {
+                continue;
+            }
+            src->last = event.ts;
+            src->cb(&event, src->arg);
+        }
+    }
+}
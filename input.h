@@ -0,0 +1,34 @@
+#ifndef INPUT_H
+#define INPUT_H
+
+#include <time.h>
+
+// 등록할 수 있는 최대 입력 핀 수
+#define INPUT_MAX 8
+
+// 입력 이벤트 (edge 발생 시 전달됨)
+typedef struct {
+    int pin;            // 이벤트가 발생한 핀
+    int value;          // edge 이후 핀 값
+    struct timespec ts; // 이벤트 발생 시각 (CLOCK_MONOTONIC)
+} InputEvent;
+
+// 입력 이벤트 콜백
+typedef void (*InputCallback)(const InputEvent *event, void *arg);
+
+/***************************************************************************
+ * input_register(int pin, const char *edge, int debounce_ms, InputCallback cb, void *arg)
+ * 입력 핀의 edge("rising", "falling", "both")를 설정하고 콜백 등록
+ * debounce_ms 안에 다시 발생한 이벤트는 무시함
+ * 핀은 미리 export, 입력 방향으로 설정되어 있어야 함
+ ***************************************************************************/
+int input_register(int pin, const char *edge, int debounce_ms, InputCallback cb, void *arg);
+
+/***************************************************************************
+ * input_loop()
+ * 등록된 핀들을 poll()로 대기하다가 edge가 발생하면 콜백 호출
+ * 이벤트가 없으면 깨어나지 않음, 스레드가 cancel 될 때까지 반환하지 않음
+ ***************************************************************************/
+void input_loop(void);
+
+#endif
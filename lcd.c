@@ -0,0 +1,303 @@
+#include <stdio.h>
+#include <unistd.h>
+#include <string.h>
+#include <time.h>
+
+#include "i2c.h"
+#include "lcd.h"
+
+#define LCD_CHR 1 // Mode - Sending data
+#define LCD_CMD 0 // Mode - Sending command
+
+// LCD 명령
+#define LCD_CLEAR 0x01
+#define LCD_SET_DDRAM 0x80 // | 주소 (1번째 줄 0x00, 2번째 줄 0x40)
+#define LCD_CLEAR_US 1520  // 화면 지우기 처리 시간 (HD44780 데이터시트)
+#define LCD_INIT_US 4100   // 첫 번째 초기화 니블 처리 시간
+#define LCD_INIT_SHORT_US 100 // 두 번째, 세 번째 초기화 니블 처리 시간
+
+#define LCD_BURST_MAX 256  // 한 번의 I2C write로 보낼 최대 바이트 수
+#define LCD_REINIT_RETRY_MS 1000 // 다시 초기화에 실패하면 이 시간 동안은 시도하지 않음
+
+// 비트 정의
+#define LCD_BACKLIGHT 0x08 // On
+#define ENABLE 0b00000100  // Enable bit
+
+static int s_lcd_fd = -1;
+static int s_bus = -1, s_addr = -1; // 다시 초기화할 때 열 장치
+static int s_faulted = 0;           // I2C write 실패 후 아직 다시 초기화하지 않음
+static struct timespec s_retry_at;  // 다음 초기화 시도 가능 시각
+static LcdStats s_stats;
+
+// 화면에 실제로 표시된 내용과 커서 위치
+static char s_shadow[LCD_ROWS][LCD_COLS];
+static int s_cursor_row = -1; // -1 = 커서 위치 모름
+static int s_cursor_col = 0;
+
+/***************************************************************************
+ * LCD 전송
+ * 명령/문자마다 PCF8574에 보낼 바이트(니블 + ENABLE 펄스)를 버퍼에 모아두고
+ * 한 번의 I2C write로 보냄
+ * 100kHz I2C에서 바이트 하나는 90us 걸리므로 ENABLE 펄스 폭(450ns)과
+ * 명령 처리 시간(37us)은 따로 기다리지 않아도 지켜짐
+ * 화면 지우기와 초기화 명령 뒤에만 데이터시트의 대기 시간을 둠
+ ***************************************************************************/
+static unsigned char s_burst[LCD_BURST_MAX];
+static int s_burst_len = 0;
+static int s_last_out = -1; // PCF8574에 마지막으로 쓴 값 (-1 = 모름)
+
+// 모아둔 바이트를 한 번에 보냄
+static int lcd_flush(void) {
+    int len = s_burst_len;
+
+    s_burst_len = 0;
+    if (s_faulted) {
+        return -1; // 이미 오류가 난 전송의 나머지는 버림
+    }
+    if (len == 0) {
+        return 0;
+    }
+    if (I2CWrite(s_lcd_fd, s_burst, len) != len) {
+        perror("lcd_flush - write"); // 쓰기 실패 시 오류 처리
+        s_stats.write_errors++;
+        s_faulted = 1; // LCD가 어떤 상태인지 알 수 없으므로 다시 초기화해야 함
+        s_last_out = -1;
+        return -1;
+    }
+    return 0;
+}
+
+// 버퍼에 한 바이트 추가
+static void lcd_out(int bits) {
+    if (s_burst_len == LCD_BURST_MAX) {
+        lcd_flush();
+    }
+    s_burst[s_burst_len++] = bits;
+    s_last_out = bits;
+}
+
+// 니블 하나를 ENABLE HIGH -> LOW로 보냄 (LOW로 내려갈 때 LCD가 읽음)
+static void lcd_nibble(int bits) {
+    // RS가 바뀌면 ENABLE을 올리기 전에 먼저 설정 (주소 설정 시간 확보)
+    if (s_last_out == -1 || (s_last_out & LCD_CHR) != (bits & LCD_CHR)) {
+        lcd_out(bits);
+    }
+    lcd_out(bits | ENABLE);
+    lcd_out(bits & ~ENABLE);
+}
+
+// LCD에 명령 또는 데이터를 보내는 함수 (lcd_flush 할 때 실제로 전송됨)
+static void lcd_byte(int bits, int mode) {
+    lcd_nibble(mode | (bits & 0xF0) | LCD_BACKLIGHT); // 상위 4비트
+    lcd_nibble(mode | ((bits << 4) & 0xF0) | LCD_BACKLIGHT); // 하위 4비트
+}
+
+// 명령을 보내고 처리 시간만큼 기다림 (화면 지우기, 초기화 명령용)
+static void lcd_command_wait(int bits, int wait_us) {
+    lcd_byte(bits, LCD_CMD);
+    lcd_flush();
+    usleep(wait_us);
+}
+
+// 초기화 명령 전송, 화면을 지우고 shadow buffer를 빈 화면으로 맞춤
+static int lcd_setup(void) {
+    // LCD 초기화 명령 전송
+    // 현재 모드(8비트/4비트)를 모르므로 상위 니블 0x3을 세 번 보내 8비트 모드로 맞춘 뒤 4비트 모드로 전환
+    s_burst_len = 0;
+    s_last_out = -1;
+    for (int i = 0; i < 3; i++) {
+        lcd_nibble(0x30 | LCD_BACKLIGHT);
+        lcd_flush();
+        usleep(i == 0 ? LCD_INIT_US : LCD_INIT_SHORT_US);
+    }
+    lcd_nibble(0x20 | LCD_BACKLIGHT); // 4비트 모드 설정
+    lcd_byte(0x06, LCD_CMD); // 커서 이동 방향 설정
+    lcd_byte(0x0C, LCD_CMD); // 디스플레이 켜기, 커서 끄기
+    lcd_byte(0x28, LCD_CMD); // 4비트 모드, 2라인, 5x7 포맷
+    lcd_command_wait(LCD_CLEAR, LCD_CLEAR_US); // 화면 지우기
+
+    // 지운 화면은 모두 공백, 커서는 첫 칸
+    memset(s_shadow, ' ', sizeof(s_shadow));
+    s_cursor_row = 0;
+    s_cursor_col = 0;
+    return s_faulted ? -1 : 0;
+}
+
+int lcd_init(int bus, int addr) {
+    if (s_lcd_fd >= 0) {
+        return 0; // 이미 초기화됨 (오류가 나면 lcd_render에서 다시 초기화)
+    }
+    printf("lcd init\n");
+    if ((s_lcd_fd = I2COpen(bus, addr)) < 0) { // I2C 버스의 LCD 장치 열기
+        return -1;
+    }
+    s_bus = bus;
+    s_addr = addr;
+    s_faulted = 0;
+    if (lcd_setup() == -1) {
+        lcd_close();
+        return -1;
+    }
+    return 0;
+}
+
+/***************************************************************************
+ * lcd_reinit()
+ * I2C write가 실패한 뒤 장치를 다시 열고 초기화 명령부터 다시 보냄
+ * 버스 오류나 LCD 전원 문제로 니블 순서가 어긋났을 수 있으므로 모드 설정부터 다시 함
+ * 실패하면 LCD_REINIT_RETRY_MS 동안은 다시 시도하지 않음 (그동안 그리기는 건너뜀)
+ ***************************************************************************/
+static int lcd_reinit(void) {
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    if (now.tv_sec < s_retry_at.tv_sec ||
+        (now.tv_sec == s_retry_at.tv_sec && now.tv_nsec < s_retry_at.tv_nsec)) {
+        return -1;
+    }
+
+    s_stats.reinits++;
+    printf("lcd re-init (%ld times)\n", s_stats.reinits);
+    if (s_lcd_fd >= 0) {
+        I2CClose(s_lcd_fd);
+    }
+    s_faulted = 0;
+    if ((s_lcd_fd = I2COpen(s_bus, s_addr)) < 0) {
+        s_faulted = 1;
+    } else {
+        lcd_setup();
+    }
+    if (s_faulted) {
+        s_stats.reinit_failures++;
+        s_retry_at = now;
+        s_retry_at.tv_sec += LCD_REINIT_RETRY_MS / 1000;
+        s_retry_at.tv_nsec += (LCD_REINIT_RETRY_MS % 1000) * 1000000L;
+        if (s_retry_at.tv_nsec >= 1000000000L) {
+            s_retry_at.tv_sec++;
+            s_retry_at.tv_nsec -= 1000000000L;
+        }
+        return -1;
+    }
+    return 0;
+}
+
+// 텍스트를 16글자에 맞춰 자르거나 공백으로 채움
+static void pad_line(char line[LCD_COLS], const char *text) {
+    int len = text ? strlen(text) : 0;
+
+    if (len > LCD_COLS) {
+        len = LCD_COLS;
+    }
+    memset(line, ' ', LCD_COLS);
+    if (len > 0) {
+        memcpy(line, text, len);
+    }
+}
+
+/***************************************************************************
+ * diff_screen(char cur[][LCD_COLS], int *row_p, int *col_p, const char next[][LCD_COLS], int emit)
+ * 화면 내용 cur(커서 위치 row_p, col_p)을 next로 바꾸는 데 필요한 바이트 수 계산
+ * emit이 1이면 실제로 LCD에 보내면서 cur와 커서 위치를 갱신함
+ * 커서가 다른 곳에 있을 때만 이동 명령을 보냄 (글자를 쓰면 커서는 자동으로 다음 칸)
+ * 바로 앞 한 칸만 같으면 이동 명령 대신 그 글자를 다시 씀 (보내는 바이트 수 동일)
+ ***************************************************************************/
+static int diff_screen(char cur[][LCD_COLS], int *row_p, int *col_p,
+                       const char next[][LCD_COLS], int emit) {
+    int cursor_row = *row_p;
+    int cursor_col = *col_p;
+    int bytes = 0;
+
+    for (int row = 0; row < LCD_ROWS; row++) {
+        for (int col = 0; col < LCD_COLS; col++) {
+            if (next[row][col] == cur[row][col]) {
+                continue;
+            }
+            if (cursor_row != row || cursor_col != col) {
+                if (cursor_row == row && cursor_col == col - 1) {
+                    if (emit) {
+                        lcd_byte(next[row][col - 1], LCD_CHR);
+                    }
+                } else if (emit) {
+                    lcd_byte(LCD_SET_DDRAM | (row ? 0x40 : 0x00) | col, LCD_CMD);
+                }
+                bytes++;
+            }
+            if (emit) {
+                lcd_byte(next[row][col], LCD_CHR);
+                cur[row][col] = next[row][col];
+            }
+            bytes++;
+            cursor_row = row;
+            cursor_col = col + 1;
+        }
+    }
+    if (emit) {
+        *row_p = cursor_row;
+        *col_p = cursor_col;
+    }
+    return bytes;
+}
+
+// 화면 내용을 next로 바꿈
+static void lcd_draw(const char next[][LCD_COLS]) {
+    char blank[LCD_ROWS][LCD_COLS];
+    int home_row = 0, home_col = 0;
+
+    // 화면 대부분이 바뀌는 경우(테마 전환)는 지우고 공백이 아닌 칸만 쓰는 편이 적게 보냄
+    // 지우기 명령 자체와 처리 대기(1.52ms)를 2바이트로 계산
+    memset(blank, ' ', sizeof(blank));
+    int diff_bytes = diff_screen(s_shadow, &s_cursor_row, &s_cursor_col, next, 0);
+    int clear_bytes = 2 + diff_screen(blank, &home_row, &home_col, next, 0);
+
+    if (clear_bytes < diff_bytes) {
+        lcd_command_wait(LCD_CLEAR, LCD_CLEAR_US); // 화면 지우기
+        memset(s_shadow, ' ', sizeof(s_shadow));
+        s_cursor_row = 0;
+        s_cursor_col = 0;
+    }
+    diff_screen(s_shadow, &s_cursor_row, &s_cursor_col, next, 1);
+    lcd_flush();
+}
+
+void lcd_render(const char *line1, const char *line2) {
+    char next[LCD_ROWS][LCD_COLS];
+
+    if (s_bus < 0) {
+        return; // lcd_init 전
+    }
+    pad_line(next[0], line1);
+    pad_line(next[1], line2);
+
+    // 그리다가 write가 실패하면 다시 초기화하고 빈 화면에서 한 번 더 그림
+    for (int attempt = 0; attempt < 2; attempt++) {
+        if (s_faulted && lcd_reinit() == -1) {
+            return;
+        }
+        lcd_draw(next);
+        if (!s_faulted) {
+            return;
+        }
+    }
+}
+
+void lcd_clear(void) {
+    lcd_render("", "");
+}
+
+void lcd_stats(LcdStats *out) {
+    *out = s_stats;
+}
+
+void lcd_close(void) {
+    if (s_stats.write_errors > 0) {
+        printf("lcd : %ld write errors, %ld re-inits (%ld failed)\n",
+               s_stats.write_errors, s_stats.reinits, s_stats.reinit_failures);
+    }
+    if (s_lcd_fd >= 0) {
+        I2CClose(s_lcd_fd);
+        s_lcd_fd = -1;
+    }
+    s_bus = -1;
+    s_addr = -1;
+    s_faulted = 0;
+}
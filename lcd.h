@@ -0,0 +1,41 @@
+#ifndef LCD_H
+#define LCD_H
+
+// 16x2 문자 LCD 크기
+#define LCD_ROWS 2
+#define LCD_COLS 16
+
+// LCD 오류 통계
+typedef struct {
+    long write_errors;    // 실패한 I2C write 수
+    long reinits;         // 오류 후 다시 초기화한 횟수
+    long reinit_failures; // 그 중 실패한 횟수
+} LcdStats;
+
+/***************************************************************************
+ * lcd_init(int bus, int addr)
+ * I2C 버스의 PCF8574 + HD44780 LCD를 열고 초기화 명령을 보낸 뒤 화면을 지움
+ * 프로그램 시작 시 한 번만 초기화하며, 이미 열려 있으면 아무것도 하지 않음
+ * 이후 I2C write가 실패했을 때만 lcd_render에서 장치를 다시 열고 초기화함
+ * (PCF8574는 LCD 상태와 관계없이 ACK 하므로 버스 오류로만 장애를 알 수 있음)
+ ***************************************************************************/
+int lcd_init(int bus, int addr);
+
+/***************************************************************************
+ * lcd_render(const char *line1, const char *line2)
+ * 화면 전체(두 줄)를 그림, 16글자보다 짧으면 공백으로 채움
+ * 화면에 이미 있는 내용(shadow buffer)과 비교해서
+ * 바뀐 칸에 대해서만 커서 이동과 문자를 보냄
+ ***************************************************************************/
+void lcd_render(const char *line1, const char *line2);
+
+// 화면 지우기 (빈 화면 그리기)
+void lcd_clear(void);
+
+// 오류 통계 복사
+void lcd_stats(LcdStats *out);
+
+// LCD 장치 닫기
+void lcd_close(void);
+
+#endif
@@ -0,0 +1,113 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <string.h>
+#include <time.h>
+
+#include "hal.h"
+#include "i2c.h"
+#include "lcd.h"
+
+// 벤치마크 설정
+#define BENCH_LCD_ADDR 0x27
+#define BENCH_LEGACY_CHARS 320   // 기존 방식은 느리므로 적게 (화면 10개 분량)
+#define BENCH_BURST_SCREENS 2000
+#define BENCH_I2C_HZ 100000      // 버스 시간 계산용 I2C 클럭
+#define BENCH_I2C_WRITE_BITS 20  // write 한 번의 START, 주소, ACK, STOP 비트 수 (대략)
+#define BENCH_I2C_BYTE_BITS 9    // 데이터 바이트 하나 + ACK
+
+#define LCD_CHR 1
+#define ENABLE 0b00000100
+#define LCD_BACKLIGHT 0x08
+
+static int s_fd;
+
+/***************************************************************************
+ * legacy_toggle_enable(int bits), legacy_byte(int bits, int mode)
+ * 기존 rpi1/rpi2의 방식 그대로 니블마다 1바이트 write 네 번과
+ * usleep(500) 세 번을 하는 함수
+ ***************************************************************************/
+static void legacy_toggle_enable(int bits) {
+    usleep(500);
+    I2CWrite(s_fd, (unsigned char*)&bits, 1);
+    bits |= ENABLE;
+    I2CWrite(s_fd, (unsigned char*)&bits, 1);
+    usleep(500);
+    bits &= ~ENABLE;
+    I2CWrite(s_fd, (unsigned char*)&bits, 1);
+    usleep(500);
+}
+
+static void legacy_byte(int bits, int mode) {
+    int bits_high = mode | (bits & 0xF0) | LCD_BACKLIGHT;
+    int bits_low = mode | ((bits << 4) & 0xF0) | LCD_BACKLIGHT;
+
+    I2CWrite(s_fd, (unsigned char*)&bits_high, 1);
+    legacy_toggle_enable(bits_high);
+    I2CWrite(s_fd, (unsigned char*)&bits_low, 1);
+    legacy_toggle_enable(bits_low);
+}
+
+// 현재 시간을 초 단위로 반환
+static double now_sec(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+// 결과 출력 : 시뮬레이터 실행 시간에 I2C 버스 전송 시간을 더해 실제 보드 속도 추정
+static void report(const char *name, long chars, double elapsed, long writes, long bytes) {
+    double bus = (writes * BENCH_I2C_WRITE_BITS + bytes * BENCH_I2C_BYTE_BITS) / (double)BENCH_I2C_HZ;
+
+    printf("%-8s: %8.0f chars/sec (sim), %7.0f chars/sec (+ %dkHz bus), %5.2f writes/char, %5.2f bytes/char\n",
+           name, chars / elapsed, chars / (elapsed + bus), BENCH_I2C_HZ / 1000,
+           (double)writes / chars, (double)bytes / chars);
+}
+
+int main(void) {
+    const char *screens[2][2] = {
+        {"ABCDEFGHIJKLMNOP", "abcdefghijklmnop"},
+        {"0123456789!@#$%^", "QRSTUVWXYZqrstuv"},
+    };
+    char line1[17], line2[17];
+    long writes0, bytes0, writes1, bytes1;
+    double start, elapsed;
+
+    // 시뮬레이터의 I2C LCD를 대상으로 측정
+    setenv("HOMEFARM_HAL", "sim", 1);
+    if (lcd_init(1, BENCH_LCD_ADDR) == -1 || (s_fd = I2COpen(1, BENCH_LCD_ADDR)) == -1) {
+        return 1;
+    }
+
+    // 기존 방식 : 문자마다 lcd_byte
+    hal_sim_i2c_stats(&writes0, &bytes0);
+    start = now_sec();
+    for (int i = 0; i < BENCH_LEGACY_CHARS; i++) {
+        legacy_byte('A' + i % 26, LCD_CHR);
+    }
+    elapsed = now_sec() - start;
+    hal_sim_i2c_stats(&writes1, &bytes1);
+    report("legacy", BENCH_LEGACY_CHARS, elapsed, writes1 - writes0, bytes1 - bytes0);
+
+    // 모아서 보내는 방식 : 모든 칸이 바뀌는 화면을 번갈아 그림
+    lcd_clear();
+    hal_sim_i2c_stats(&writes0, &bytes0);
+    start = now_sec();
+    for (int i = 0; i < BENCH_BURST_SCREENS; i++) {
+        lcd_render(screens[i % 2][0], screens[i % 2][1]);
+    }
+    elapsed = now_sec() - start;
+    hal_sim_i2c_stats(&writes1, &bytes1);
+    report("burst", (long)BENCH_BURST_SCREENS * 32, elapsed, writes1 - writes0, bytes1 - bytes0);
+
+    // 마지막 화면이 제대로 그려졌는지 확인
+    hal_sim_lcd_snapshot(line1, line2);
+    if (strcmp(line1, screens[1][0]) != 0 || strcmp(line2, screens[1][1]) != 0) {
+        fprintf(stderr, "LCD contents mismatch: [%s] [%s]\n", line1, line2);
+        return 1;
+    }
+
+    I2CClose(s_fd);
+    lcd_close();
+    return 0;
+}
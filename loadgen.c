@@ -0,0 +1,538 @@
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <time.h>
+#include <unistd.h>
+#include <stdint.h>
+#include <arpa/inet.h>
+#include <netinet/tcp.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <sys/timerfd.h>
+
+#include "proto.h"
+#include "reactor.h"
+#include "heartbeat.h"
+#include "telemetry.h"
+
+/***************************************************************************
+ * homefarm-loadgen
+ * 가짜 rpi1/rpi3 노드 수천 개를 loopback으로 허브(rpi2)에 연결하여 부하를 줌
+ * 노드는 실제 프로토콜을 사용 (HELLO, 구독, PING 응답)
+ *  rpi3 역할 : TEMP / HUMID 요청, LED ON/OFF, WATER LOW/OK 이벤트
+ *  rpi1 역할 : PLANT UPDATE 요청
+ * 1초마다 처리량, 응답 시간 p50/p99/p999를 출력하고
+ * -R로 노드를 조금씩 늘리면 허브가 포화되는 연결 수를 찾음
+ * 첫 노드가 연결된 뒤 -w초(허브와 연결이 자리잡는 시간)는 출력만 하고 합계와 포화 판정에서 뺌
+ ***************************************************************************/
+
+#define LOADGEN_TICK_MS 10          // 요청을 보내는 간격
+#define LOADGEN_PENDING 64          // 노드 하나가 응답을 기다릴 수 있는 요청 수
+#define LOADGEN_STALL_US 2000000LL  // 이보다 오래 응답이 없으면 멈춘 것으로 봄
+#define LAT_SUB_BITS 3              // 2배 구간마다 8칸 (오차 12.5% 이내)
+#define LAT_BUCKETS (40 << LAT_SUB_BITS)
+
+// 응답 시간 분포 (us)
+typedef struct {
+    long count[LAT_BUCKETS];
+    long total;
+} Latency;
+
+// 가짜 노드 하나
+typedef struct {
+    ReactorWatch watch;
+    ProtoConn proto;
+    ProtoQueue txq;
+    int want_out;
+    int role;
+    int connected;             // HELLO까지 보냄
+    int closed;
+    unsigned int next_id;      // 요청 번호
+    long long sent_us[LOADGEN_PENDING]; // 응답을 기다리는 요청의 보낸 시각 (허브는 연결마다 순서대로 응답)
+    unsigned char warm[LOADGEN_PENDING]; // 준비 시간이 끝난 뒤 보낸 요청 (합계에 넣음)
+    int head;
+    int pending;
+    int event;                 // 다음 이벤트 (LED ON, LED OFF, WATER LOW, WATER OK 순서)
+} Client;
+
+// 설정
+static int s_clients = 1000;
+static double s_rate = 1.0;     // 노드 하나의 초당 요청 수
+static double s_events = 0.2;   // 노드 하나의 초당 이벤트 수
+static int s_duration = 0;      // 0 = 기본값
+static int s_ramp = 0;          // 초당 늘릴 노드 수 (0 = 처음에 모두 연결)
+static int s_limit_ms = 50;     // p99가 이보다 크면 포화
+static int s_warmup = 2;        // 합계, 포화 판정에서 뺄 처음 시간 (초)
+static struct sockaddr_in s_addr;
+
+static Client *s_pool;
+static int s_started;           // 연결을 시작한 노드 수
+static int s_open;              // 연결된 노드 수
+static int s_rr_req, s_rr_event;
+static double s_req_credit, s_event_credit;
+static long long s_begin_us;    // 실행 시작
+static long long s_ready_us;    // 첫 노드가 연결된 시각
+static long long s_start_us, s_last_tick_us, s_last_report_us; // s_start_us : 준비 시간이 끝난 시각
+
+// 전체 / 1초 구간 통계
+static Latency s_total, s_interval;
+static long s_requests, s_replies, s_events_sent, s_pushes;
+static long s_int_requests, s_int_replies, s_int_events, s_int_pushes;
+static long s_connect_failed, s_hub_closed, s_throttled;
+static int s_warm = 0;          // 준비 시간이 지남
+static int s_saturated_at = 0;
+static const char *s_saturation_reason = "";
+
+static long long now_us(void) {
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000000LL + ts.tv_nsec / 1000;
+}
+
+static int lat_bucket(long long us) {
+    int msb, idx;
+
+    if (us < (1 << LAT_SUB_BITS)) {
+        return us < 0 ? 0 : (int)us;
+    }
+    msb = 63 - __builtin_clzll(us);
+    idx = ((msb - LAT_SUB_BITS + 1) << LAT_SUB_BITS) + (int)((us >> (msb - LAT_SUB_BITS)) & ((1 << LAT_SUB_BITS) - 1));
+    return idx < LAT_BUCKETS ? idx : LAT_BUCKETS - 1;
+}
+
+// 칸의 상한 (us)
+static long long lat_upper(int idx) {
+    int shift;
+
+    if (idx < (1 << LAT_SUB_BITS)) {
+        return idx + 1;
+    }
+    shift = (idx >> LAT_SUB_BITS) - 1;
+    return (long long)((1 << LAT_SUB_BITS) + (idx & ((1 << LAT_SUB_BITS) - 1)) + 1) << shift;
+}
+
+static void lat_add(Latency *l, long long us) {
+    l->count[lat_bucket(us)]++;
+    l->total++;
+}
+
+// 전체 중 permille/1000이 이 값(us) 이하 (기록이 없으면 0)
+static long long lat_percentile(const Latency *l, int permille) {
+    long target = (l->total * permille + 999) / 1000;
+    long seen = 0;
+
+    if (l->total == 0) {
+        return 0;
+    }
+    for (int i = 0; i < LAT_BUCKETS; i++) {
+        seen += l->count[i];
+        if (seen >= target) {
+            return lat_upper(i);
+        }
+    }
+    return lat_upper(LAT_BUCKETS - 1);
+}
+
+static void client_close(Client *c, int by_hub) {
+    if (c->closed) {
+        return;
+    }
+    c->closed = 1;
+    if (c->connected) {
+        s_open--;
+    }
+    if (by_hub) {
+        s_hub_closed++;
+    }
+    reactor_del(&c->watch);
+    close(c->watch.fd);
+    c->watch.fd = -1;
+    c->proto.fd = -1; // 이후의 전송은 ENOTCONN (대기열은 종료할 때 해제)
+}
+
+// 쌓인 메시지 전송 (rpi2의 conn_flush와 같은 방식)
+static void client_flush(void *arg) {
+    Client *c = arg;
+    int ret;
+
+    if (c->closed) {
+        return;
+    }
+    ret = proto_queue_flush(&c->proto);
+    if (ret == -1) {
+        client_close(c, 1);
+    } else if (ret == 0 && !c->want_out) {
+        c->want_out = 1;
+        reactor_mod(&c->watch, EPOLLIN | EPOLLOUT);
+    } else if (ret == 1 && c->want_out) {
+        c->want_out = 0;
+        reactor_mod(&c->watch, EPOLLIN);
+    }
+}
+
+static void on_client_push(void *arg) {
+    Client *c = arg;
+
+    if (!c->want_out) {
+        reactor_defer(client_flush, c);
+    }
+}
+
+// HELLO (노드마다 다른 node_id, 구역은 0 ~ 15 돌아가며) + 구독
+static void client_hello(Client *c) {
+    unsigned char hello[PROTO_HELLO_LEN];
+    unsigned short version16 = htons(PROTO_VERSION);
+    int index = c - s_pool;
+    unsigned int node32 = htonl(0x10000000u + index);
+
+    memcpy(hello, &version16, 2);
+    hello[2] = c->role;
+    hello[3] = index % 16;
+    memcpy(hello + 4, &node32, 4);
+    proto_send(&c->proto, PROTO_HELLO, hello, PROTO_HELLO_LEN);
+    // rpi1 : 온습도 + LED, rpi3 : 온습도
+    telemetry_subscribe(&c->proto, c->role == ROLE_DISPLAY ? TOPIC_ENV | TOPIC_LED : TOPIC_ENV);
+    c->connected = 1;
+    s_open++;
+    if (s_ready_us == 0) {
+        s_ready_us = now_us();
+    }
+}
+
+/***************************************************************************
+ * client_reply(Client *c)
+ * 응답 하나 도착 (가장 오래된 요청의 응답)
+ * 준비 시간에 보낸 요청의 응답은 초마다 출력에만 넣고 합계에서는 뺌
+ * (합계를 지운 뒤에 도착해도 응답 수가 보낸 수보다 많아지지 않게)
+ ***************************************************************************/
+static void client_reply(Client *c) {
+    long long rtt;
+    int warm;
+
+    if (c->pending == 0) {
+        return;
+    }
+    rtt = now_us() - c->sent_us[c->head];
+    warm = c->warm[c->head];
+    c->head = (c->head + 1) % LOADGEN_PENDING;
+    c->pending--;
+    lat_add(&s_interval, rtt);
+    s_int_replies++;
+    if (warm) {
+        lat_add(&s_total, rtt);
+        s_replies++;
+    }
+}
+
+static void on_client_event(ReactorWatch *w, unsigned int events) {
+    Client *c = w->arg;
+    ProtoMsg msg;
+    int n;
+
+    if (!c->connected) {
+        int err = 0;
+        socklen_t len = sizeof(err);
+        if (getsockopt(w->fd, SOL_SOCKET, SO_ERROR, &err, &len) == -1 || err != 0) {
+            s_connect_failed++;
+            client_close(c, 0);
+            return;
+        }
+        reactor_mod(w, EPOLLIN);
+        client_hello(c);
+        return;
+    }
+    if (events & EPOLLOUT) {
+        client_flush(c);
+    }
+    if (c->closed || !(events & (EPOLLIN | EPOLLHUP | EPOLLERR))) {
+        return;
+    }
+
+    while ((n = proto_recv(&c->proto)) > 0) {
+        while (proto_next(&c->proto, &msg) == 1) {
+            if (msg.type == PROTO_PING) {
+                heartbeat_pong(&c->proto, &msg);
+            } else if (msg.type == PROTO_REPLY) {
+                client_reply(c);
+            } else {
+                s_pushes++;
+                s_int_pushes++;
+            }
+        }
+    }
+    if (n == 0 || (n < 0 && errno != EAGAIN && errno != EWOULDBLOCK)) {
+        client_close(c, 1);
+    }
+}
+
+// 노드 하나 연결 시작 (non-blocking connect, 연결되면 on_client_event에서 HELLO)
+static void client_start(Client *c, int index) {
+    int fd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    int on = 1;
+
+    c->role = index % 2 ? ROLE_DISPLAY : ROLE_ACTUATOR;
+    c->watch.fd = fd;
+    c->watch.handler = on_client_event;
+    c->watch.arg = c;
+    if (fd == -1) {
+        s_connect_failed++;
+        c->closed = 1;
+        return;
+    }
+    proto_conn_init(&c->proto, fd);
+    proto_queue_attach(&c->proto, &c->txq, on_client_push, c);
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &on, sizeof(on)); // 노드와 같게 (heartbeat_tune_socket)
+    if ((connect(fd, (struct sockaddr*)&s_addr, sizeof(s_addr)) == -1 && errno != EINPROGRESS) ||
+        reactor_add(&c->watch, EPOLLOUT) == -1) {
+        s_connect_failed++;
+        close(fd);
+        c->closed = 1;
+    }
+}
+
+// 연결된 다음 노드 (돌아가면서)
+static Client *next_open(int *rr) {
+    for (int i = 0; i < s_started; i++) {
+        Client *c = &s_pool[*rr];
+        *rr = (*rr + 1) % s_started;
+        if (c->connected && !c->closed) {
+            return c;
+        }
+    }
+    return NULL;
+}
+
+static void send_request(Client *c) {
+    unsigned int id32 = htonl(c->next_id++);
+    int opcode;
+
+    if (c->pending == LOADGEN_PENDING) {
+        s_throttled++; // 응답이 밀려 있음, 보내지 않음
+        return;
+    }
+    if (c->role == ROLE_DISPLAY) {
+        opcode = PROTO_PLANT_UPDATE;
+    } else {
+        opcode = c->next_id % 2 ? PROTO_TEMP : PROTO_HUMID;
+    }
+    if (proto_send(&c->proto, opcode, &id32, sizeof(id32)) == -1) {
+        return;
+    }
+    c->sent_us[(c->head + c->pending) % LOADGEN_PENDING] = now_us();
+    c->warm[(c->head + c->pending) % LOADGEN_PENDING] = s_warm;
+    c->pending++;
+    s_requests++;
+    s_int_requests++;
+}
+
+static void send_event(Client *c) {
+    static const int events[] = { PROTO_LED_ON, PROTO_LED_OFF, PROTO_WATER_LOW, PROTO_WATER_OK };
+
+    if (proto_send_op(&c->proto, events[c->event]) == 0) {
+        c->event = (c->event + 1) % 4;
+        s_events_sent++;
+        s_int_events++;
+    }
+}
+
+// 응답이 오래 없는 노드 수
+static int count_stalled(long long now) {
+    int stalled = 0;
+
+    for (int i = 0; i < s_started; i++) {
+        Client *c = &s_pool[i];
+        if (!c->closed && c->pending > 0 && now - c->sent_us[c->head] > LOADGEN_STALL_US) {
+            stalled++;
+        }
+    }
+    return stalled;
+}
+
+// 1초 구간 결과 출력, 포화 판정
+static void report(long long now) {
+    double sec = (now - s_last_report_us) / 1e6;
+    int stalled = count_stalled(now);
+    long long p99 = lat_percentile(&s_interval, 990);
+
+    printf("%5.1f %8d %9.0f %9.0f %9.0f %8lld %8lld %8lld %7d\n",
+           (now - s_begin_us) / 1e6, s_open, s_int_replies / sec, s_int_events / sec, s_int_pushes / sec,
+           lat_percentile(&s_interval, 500), p99, lat_percentile(&s_interval, 999), stalled);
+    fflush(stdout);
+
+    if (!s_warm && s_ready_us > 0 && now - s_ready_us >= s_warmup * 1000000LL) {
+        // 준비 시간 동안의 결과는 버림
+        s_warm = 1;
+        s_start_us = now;
+        memset(&s_total, 0, sizeof(s_total));
+        s_requests = s_replies = s_events_sent = s_pushes = 0;
+        s_connect_failed = s_hub_closed = s_throttled = 0;
+    } else if (s_warm && s_saturated_at == 0 && s_open > 0) {
+        if (p99 > s_limit_ms * 1000LL) {
+            s_saturation_reason = "p99 over limit";
+        } else if (stalled > 0) {
+            s_saturation_reason = "requests stalled";
+        } else if (s_hub_closed > 0 || s_connect_failed > 0) {
+            s_saturation_reason = "connections refused or dropped";
+        }
+        if (s_saturation_reason[0]) {
+            s_saturated_at = s_open;
+        }
+    }
+    memset(&s_interval, 0, sizeof(s_interval));
+    s_int_requests = s_int_replies = s_int_events = s_int_pushes = 0;
+    s_last_report_us = now;
+}
+
+static void on_tick(ReactorWatch *w, unsigned int events) {
+    uint64_t expirations;
+    long long now = now_us();
+    double dt = (now - s_last_tick_us) / 1e6;
+    int target = s_clients;
+
+    if (read(w->fd, &expirations, sizeof(expirations)) != sizeof(expirations)) {
+        return;
+    }
+    s_last_tick_us = now;
+
+    // 노드 늘리기 (준비 시간 동안은 처음 s_ramp개만)
+    if (s_ramp > 0) {
+        long long ramped = s_warm ? (long long)s_ramp * (now - s_start_us) / 1000000 + s_ramp : s_ramp;
+        target = ramped < s_clients ? (int)ramped : s_clients;
+    }
+    while (s_started < target) {
+        client_start(&s_pool[s_started], s_started);
+        s_started++;
+    }
+
+    // 연결된 노드 수에 맞춰 요청, 이벤트 전송 (노드를 돌아가면서)
+    s_req_credit += s_open * s_rate * dt;
+    s_event_credit += s_open * s_events * dt;
+    while (s_req_credit >= 1) {
+        Client *c = next_open(&s_rr_req);
+        if (c == NULL) {
+            s_req_credit = 0;
+            break;
+        }
+        send_request(c);
+        s_req_credit--;
+    }
+    while (s_event_credit >= 1) {
+        Client *c = next_open(&s_rr_event);
+        if (c == NULL) {
+            s_event_credit = 0;
+            break;
+        }
+        send_event(c);
+        s_event_credit--;
+    }
+
+    if (now - s_last_report_us >= 1000000) {
+        report(now);
+        // 노드를 늘리는 중에 포화되면 더 볼 필요 없음
+        if (s_ramp > 0 && s_saturated_at > 0) {
+            reactor_stop();
+        }
+    }
+    if (s_warm && now - s_start_us >= s_duration * 1000000LL) {
+        reactor_stop();
+    }
+}
+
+static void usage(const char *prog) {
+    printf("usage : %s [-n clients] [-r requests/s per client] [-e events/s per client]\n"
+           "          [-d seconds] [-R clients added per second] [-L p99 limit ms] [-w warmup seconds]\n"
+           "          [-H host] [-P port]\n", prog);
+}
+
+int main(int argc, char *argv[]) {
+    const char *host = "127.0.0.1";
+    int port = 2586;
+    int opt;
+    struct rlimit rl;
+    struct itimerspec its;
+    ReactorWatch tick_watch;
+    double elapsed;
+
+    while ((opt = getopt(argc, argv, "n:r:e:d:R:L:w:H:P:h")) != -1) {
+        switch (opt) {
+        case 'n': s_clients = atoi(optarg); break;
+        case 'r': s_rate = atof(optarg); break;
+        case 'e': s_events = atof(optarg); break;
+        case 'd': s_duration = atoi(optarg); break;
+        case 'R': s_ramp = atoi(optarg); break;
+        case 'L': s_limit_ms = atoi(optarg); break;
+        case 'w': s_warmup = atoi(optarg); break;
+        case 'H': host = optarg; break;
+        case 'P': port = atoi(optarg); break;
+        default: usage(argv[0]); return 1;
+        }
+    }
+    if (s_clients < 1) {
+        usage(argv[0]);
+        return 1;
+    }
+    if (s_duration <= 0) {
+        s_duration = s_ramp > 0 ? s_clients / s_ramp + 5 : 10;
+    }
+    memset(&s_addr, 0, sizeof(s_addr));
+    s_addr.sin_family = AF_INET;
+    s_addr.sin_port = htons(port);
+    if (inet_pton(AF_INET, host, &s_addr.sin_addr) != 1) {
+        printf("Invalid host %s\n", host);
+        return 1;
+    }
+
+    // 노드마다 소켓 하나
+    if (getrlimit(RLIMIT_NOFILE, &rl) == 0 && rl.rlim_cur < rl.rlim_max) {
+        rl.rlim_cur = rl.rlim_max;
+        setrlimit(RLIMIT_NOFILE, &rl);
+    }
+    s_pool = calloc(s_clients, sizeof(Client));
+    if (s_pool == NULL || reactor_open() == -1) {
+        perror("loadgen init");
+        return 1;
+    }
+    tick_watch.fd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    tick_watch.handler = on_tick;
+    tick_watch.arg = NULL;
+    memset(&its, 0, sizeof(its));
+    its.it_value.tv_nsec = LOADGEN_TICK_MS * 1000000L;
+    its.it_interval = its.it_value;
+    if (tick_watch.fd == -1 || timerfd_settime(tick_watch.fd, 0, &its, NULL) == -1 || reactor_add(&tick_watch, EPOLLIN) == -1) {
+        perror("loadgen timer");
+        return 1;
+    }
+
+    printf("%d clients%s, %.2f requests/s and %.2f events/s each, %d s after %d s warmup\n", s_clients,
+           s_ramp > 0 ? " (ramped)" : "", s_rate, s_events, s_duration, s_warmup);
+    printf("%5s %8s %9s %9s %9s %8s %8s %8s %7s\n", "t", "clients", "reply/s", "event/s", "push/s",
+           "p50 us", "p99 us", "p999 us", "stalled");
+    s_begin_us = s_start_us = s_last_tick_us = s_last_report_us = now_us();
+    reactor_run();
+    elapsed = (now_us() - s_start_us) / 1e6;
+
+    printf("\nrequests   : %ld sent, %ld replied, %.0f replies/s, %ld throttled\n",
+           s_requests, s_replies, s_replies / elapsed, s_throttled);
+    printf("events     : %ld sent, %.0f events/s, %ld pushes received (%.0f/s)\n",
+           s_events_sent, s_events_sent / elapsed, s_pushes, s_pushes / elapsed);
+    printf("latency    : p50 < %lld us, p99 < %lld us, p999 < %lld us\n",
+           lat_percentile(&s_total, 500), lat_percentile(&s_total, 990), lat_percentile(&s_total, 999));
+    printf("clients    : %d connected, %ld connect failures, %ld closed by hub\n", s_open, s_connect_failed, s_hub_closed);
+    if (s_saturated_at > 0) {
+        printf("saturation : %d connections (%s)\n", s_saturated_at, s_saturation_reason);
+    } else {
+        printf("saturation : not reached with %d connections\n", s_open);
+    }
+
+    for (int i = 0; i < s_started; i++) {
+        client_close(&s_pool[i], 0);
+        proto_queue_clear(&s_pool[i].proto);
+    }
+    reactor_close();
+    free(s_pool);
+    return 0;
+}
@@ -0,0 +1,265 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <signal.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <arpa/inet.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+
+#include "multicast.h"
+#include "heartbeat.h"
+
+#define MCAST_DATAGRAM_LEN (PROTO_HEADER_LEN + TELEMETRY_SNAPSHOT_LEN)
+
+// 환경변수에서 그룹 주소, 인터페이스 주소 읽기 (그룹이 없으면 -1)
+static int mcast_config(struct sockaddr_in *group, struct in_addr *iface) {
+    const char *group_env = getenv("HOMEFARM_MCAST_GROUP");
+    const char *port_env = getenv("HOMEFARM_MCAST_PORT");
+    const char *if_env = getenv("HOMEFARM_MCAST_IF");
+
+    if (group_env == NULL || group_env[0] == '\0') {
+        return -1;
+    }
+    memset(group, 0, sizeof(*group));
+    group->sin_family = AF_INET;
+    group->sin_port = htons(port_env ? atoi(port_env) : MCAST_PORT);
+    if (inet_pton(AF_INET, group_env, &group->sin_addr) != 1 || !IN_MULTICAST(ntohl(group->sin_addr.s_addr))) {
+        printf("HOMEFARM_MCAST_GROUP %s is not a multicast address\n", group_env);
+        return -1;
+    }
+    iface->s_addr = htonl(INADDR_ANY);
+    if (if_env && inet_pton(AF_INET, if_env, iface) != 1) {
+        printf("HOMEFARM_MCAST_IF %s is not an address\n", if_env);
+        return -1;
+    }
+    return 0;
+}
+
+int mcast_sender_open(McastSender *s) {
+    struct in_addr iface;
+    unsigned char ttl = 1;  // 온실 LAN 밖으로 나가지 않음
+    unsigned char loop = 1; // 같은 장치의 노드도 받음
+    char addr[INET_ADDRSTRLEN];
+
+    memset(s, 0, sizeof(McastSender));
+    s->fd = -1;
+    if (mcast_config(&s->group, &iface) == -1) {
+        return -1;
+    }
+    s->fd = socket(AF_INET, SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (s->fd == -1) {
+        perror("multicast socket");
+        return -1;
+    }
+    setsockopt(s->fd, IPPROTO_IP, IP_MULTICAST_TTL, &ttl, sizeof(ttl));
+    setsockopt(s->fd, IPPROTO_IP, IP_MULTICAST_LOOP, &loop, sizeof(loop));
+    if (iface.s_addr != htonl(INADDR_ANY) &&
+        setsockopt(s->fd, IPPROTO_IP, IP_MULTICAST_IF, &iface, sizeof(iface)) == -1) {
+        perror("IP_MULTICAST_IF");
+        mcast_sender_close(s);
+        return -1;
+    }
+    inet_ntop(AF_INET, &s->group.sin_addr, addr, sizeof(addr));
+    printf("Multicast snapshots to %s:%d\n", addr, ntohs(s->group.sin_port));
+    return 0;
+}
+
+// 보내지 못해도 괜찮음 (노드가 seq로 알 수 있고 다음 heartbeat에 다시 보냄)
+static void mcast_send(McastSender *s) {
+    if (sendto(s->fd, s->last, MCAST_DATAGRAM_LEN, 0, (struct sockaddr*)&s->group, sizeof(s->group)) == -1 &&
+        errno != EAGAIN && errno != EWOULDBLOCK) {
+        perror("multicast sendto");
+    }
+}
+
+void mcast_publish(McastSender *s, const Telemetry *t, int changed) {
+    unsigned short type16 = htons(PROTO_SNAPSHOT);
+    unsigned short length16 = htons(TELEMETRY_SNAPSHOT_LEN);
+    unsigned int seq32;
+
+    if (s->fd < 0) {
+        return;
+    }
+    seq32 = htonl(s->seq++);
+    memcpy(s->last, &type16, 2);
+    memcpy(s->last + 2, &length16, 2);
+    memcpy(s->last + 4, &seq32, 4);
+    telemetry_encode_snapshot(t, changed, s->last + PROTO_HEADER_LEN);
+    s->have_last = 1;
+    mcast_send(s);
+}
+
+void mcast_repeat(McastSender *s) {
+    if (s->fd >= 0 && s->have_last) {
+        mcast_send(s);
+    }
+}
+
+void mcast_sender_close(McastSender *s) {
+    if (s->fd >= 0) {
+        close(s->fd);
+    }
+    s->fd = -1;
+}
+
+/***************************************************************************
+ * 노드 쪽 수신 스레드
+ * datagram이 heartbeat 허용 시간 동안 오지 않으면 TCP 구독으로 돌아가고
+ * 다시 순서대로 오기 시작하면 multicast로 돌아옴
+ ***************************************************************************/
+static int s_fd = -1;
+static pthread_t s_thread;
+static ProtoConn *s_conn;
+static int s_topics;
+static volatile sig_atomic_t s_via_mcast = 0; // 1 = 허브가 TCP로 바뀐 값을 보내지 않음
+static volatile sig_atomic_t s_stop = 0;
+static long s_received, s_gaps, s_resyncs;
+
+// 받은 datagram 검사 (0 = snapshot, -1 = 다른 메시지)
+static int parse_datagram(const unsigned char *buf, int n, unsigned int *seq, Telemetry *t, int *changed) {
+    unsigned short type16, length16;
+    unsigned int seq32;
+
+    if (n != MCAST_DATAGRAM_LEN) {
+        return -1;
+    }
+    memcpy(&type16, buf, 2);
+    memcpy(&length16, buf + 2, 2);
+    memcpy(&seq32, buf + 4, 4);
+    if (ntohs(type16) != PROTO_SNAPSHOT || ntohs(length16) != TELEMETRY_SNAPSHOT_LEN) {
+        return -1;
+    }
+    *seq = ntohl(seq32);
+    return telemetry_decode_snapshot(buf + PROTO_HEADER_LEN, TELEMETRY_SNAPSHOT_LEN, t, changed);
+}
+
+// 구독 다시 보내기 (허브가 TCP로 현재 값을 한 번 보냄, 연결이 끊긴 동안에는 다시 연결할 때 보냄)
+static void resubscribe(void) {
+    telemetry_subscribe(s_conn, mcast_topics(s_topics));
+}
+
+static void *mcast_thread(void *arg) {
+    unsigned char buf[MCAST_DATAGRAM_LEN + 1];
+    unsigned int expected = 0;
+    int have_seq = 0;
+
+    while (!s_stop) {
+        Telemetry t;
+        unsigned int seq;
+        int changed;
+        int n = recv(s_fd, buf, sizeof(buf), 0);
+
+        if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            if (s_via_mcast) {
+                printf("No multicast snapshots, back to TCP\n");
+                s_via_mcast = 0;
+                resubscribe();
+            }
+            continue;
+        }
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            break; // mcast_stop
+        }
+        if (parse_datagram(buf, n, &seq, &t, &changed) == -1) {
+            continue;
+        }
+
+        int diff = (int)(seq - expected);
+        if (have_seq && diff == -1) {
+            continue; // 허브가 다시 보낸 마지막 datagram
+        }
+        s_received++;
+        telemetry_store(&t); // snapshot은 전체 값이므로 빠진 것이 있어도 최신 값
+        if (have_seq && diff > 0) {
+            s_gaps += diff;
+            printf("Multicast gap : seq %u, expected %u\n", seq, expected);
+        } else if (have_seq && diff < -1) {
+            printf("Multicast seq restarted at %u (hub restarted)\n", seq);
+        }
+        expected = seq + 1;
+
+        if (!s_via_mcast) {
+            printf("Receiving snapshots by multicast\n");
+            s_via_mcast = 1;
+            resubscribe();
+        } else if (have_seq && diff != 0) {
+            // 빠진 datagram의 바뀐 값 표시는 알 수 없으므로 TCP로 다시 받음
+            s_resyncs++;
+            resubscribe();
+        }
+        have_seq = 1;
+    }
+    return NULL;
+}
+
+int mcast_start(ProtoConn *conn, int topics) {
+    struct sockaddr_in group, local;
+    struct in_addr iface;
+    struct ip_mreq mreq;
+    struct timeval timeout;
+    int interval_ms, misses;
+    int on = 1;
+
+    if (mcast_config(&group, &iface) == -1) {
+        return -1;
+    }
+    s_fd = socket(AF_INET, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+    if (s_fd == -1) {
+        perror("multicast socket");
+        return -1;
+    }
+    // 같은 장치에서 디스플레이 여러 개가 같은 포트로 받을 수 있게
+    setsockopt(s_fd, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on));
+    memset(&local, 0, sizeof(local));
+    local.sin_family = AF_INET;
+    local.sin_port = group.sin_port;
+    local.sin_addr = group.sin_addr;
+    mreq.imr_multiaddr = group.sin_addr;
+    mreq.imr_interface = iface;
+    if (bind(s_fd, (struct sockaddr*)&local, sizeof(local)) == -1 ||
+        setsockopt(s_fd, IPPROTO_IP, IP_ADD_MEMBERSHIP, &mreq, sizeof(mreq)) == -1) {
+        perror("multicast join");
+        close(s_fd);
+        s_fd = -1;
+        return -1;
+    }
+
+    // 허브는 heartbeat마다 다시 보내므로 TCP 연결 감시와 같은 시간을 기다림
+    heartbeat_config(&interval_ms, &misses);
+    timeout.tv_sec = interval_ms * (misses + 1) / 1000;
+    timeout.tv_usec = interval_ms * (misses + 1) % 1000 * 1000;
+    setsockopt(s_fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+
+    s_conn = conn;
+    s_topics = topics;
+    s_stop = 0;
+    if (pthread_create(&s_thread, NULL, mcast_thread, NULL) != 0) {
+        perror("multicast thread");
+        close(s_fd);
+        s_fd = -1;
+        return -1;
+    }
+    return 0;
+}
+
+int mcast_topics(int topics) {
+    return s_via_mcast ? topics | TOPIC_MULTICAST : topics;
+}
+
+void mcast_stop(void) {
+    if (s_fd < 0) {
+        return;
+    }
+    s_stop = 1;
+    shutdown(s_fd, SHUT_RDWR); // recv를 깨움
+    pthread_join(s_thread, NULL);
+    close(s_fd);
+    s_fd = -1;
+    printf("Multicast : %ld snapshots, %ld missed, %ld resyncs\n", s_received, s_gaps, s_resyncs);
+}
@@ -0,0 +1,61 @@
+#ifndef MULTICAST_H
+#define MULTICAST_H
+
+#include <netinet/in.h>
+
+#include "proto.h"
+#include "telemetry.h"
+
+#define MCAST_PORT 2587  // 기본 multicast 포트 (HOMEFARM_MCAST_PORT)
+
+/***************************************************************************
+ * UDP multicast로 snapshot 보내기 (선택 사항, HOMEFARM_MCAST_GROUP이 있을 때만)
+ * 디스플레이가 많아도 허브는 바뀐 값을 datagram 한 번으로 보냄
+ *
+ *  datagram :  | type = PROTO_SNAPSHOT (2) | length (2) | seq (4) | snapshot (telemetry.h) |
+ *
+ * seq는 TCP 연결과 별개로 multicast 채널에서 1씩 증가
+ * 허브는 heartbeat마다 마지막 datagram을 다시 보냄 (마지막 datagram이 빠져도 알 수 있음)
+ * 노드는 seq가 건너뛰면 TCP로 현재 값을 다시 받고, datagram이 오지 않으면 TCP 구독으로 돌아감
+ *
+ * HOMEFARM_MCAST_GROUP : 그룹 주소 (예 239.255.70.1)
+ * HOMEFARM_MCAST_PORT  : 포트
+ * HOMEFARM_MCAST_IF    : 보내고 받을 인터페이스 주소 (loopback 시험은 127.0.0.1)
+ ***************************************************************************/
+
+// 허브 쪽 multicast 채널
+typedef struct {
+    int fd;                  // -1 = 사용 안 함
+    struct sockaddr_in group;
+    unsigned int seq;        // 다음에 보낼 seq
+    unsigned char last[PROTO_HEADER_LEN + TELEMETRY_SNAPSHOT_LEN]; // 마지막으로 보낸 datagram
+    int have_last;
+} McastSender;
+
+// 채널 열기 (환경변수가 없거나 실패하면 fd = -1, 반환 -1)
+int mcast_sender_open(McastSender *s);
+
+// snapshot 한 번 보내기 (fd = -1 이면 아무것도 하지 않음)
+void mcast_publish(McastSender *s, const Telemetry *t, int changed);
+
+// 마지막 snapshot 다시 보내기 (같은 seq)
+void mcast_repeat(McastSender *s);
+
+void mcast_sender_close(McastSender *s);
+
+/***************************************************************************
+ * 노드 쪽
+ * mcast_start(ProtoConn *conn, int topics)
+ * 그룹에 가입하고 수신 스레드 시작 (받은 snapshot은 telemetry_store로 저장)
+ * 환경변수가 없으면 -1 (TCP로만 받음)
+ * 구독은 mcast_topics(topics)로 보내야 함 (multicast로 받는 동안 허브는 TCP로 바뀐 값을 보내지 않음)
+ ***************************************************************************/
+int mcast_start(ProtoConn *conn, int topics);
+
+// 지금 구독 메시지로 보낼 값 (multicast로 받는 중이면 TOPIC_MULTICAST 추가)
+int mcast_topics(int topics);
+
+// 수신 스레드 종료, 받은 수와 빠진 수 출력
+void mcast_stop(void);
+
+#endif
@@ -0,0 +1,395 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <poll.h>
+#include <sys/uio.h>
+#include <sys/socket.h>
+#include <arpa/inet.h>
+
+#include "proto.h"
+
+#define RING_MASK (PROTO_RING_SIZE - 1)
+#define PROTO_SEND_TIMEOUT_MS 1000 // non-blocking 소켓의 송신 버퍼가 빌 때까지 기다릴 최대 시간
+
+void proto_conn_init(ProtoConn *conn, int fd) {
+    conn->fd = fd;
+    conn->head = 0;
+    conn->tail = 0;
+    conn->rx_seq = 0;
+    conn->rx_seq_gaps = 0;
+    conn->tx_seq = 0;
+    conn->txq = NULL;
+    pthread_mutex_init(&conn->tx_lock, NULL);
+}
+
+void proto_conn_reset(ProtoConn *conn, int fd) {
+    // 다른 스레드가 보내는 중이면 끝날 때까지 기다렸다가 바꿈
+    pthread_mutex_lock(&conn->tx_lock);
+    conn->fd = fd;
+    conn->tx_seq = 0;
+    pthread_mutex_unlock(&conn->tx_lock);
+    conn->head = 0;
+    conn->tail = 0;
+    conn->rx_seq = 0;
+}
+
+int proto_recv(ProtoConn *conn) {
+    unsigned int used = conn->tail - conn->head;
+    unsigned int space = PROTO_RING_SIZE - used;
+    unsigned int pos = conn->tail & RING_MASK;
+    struct iovec iov[2];
+    int iovcnt = 1;
+    ssize_t n;
+
+    if (space == 0) {
+        errno = ENOBUFS; // 메시지를 꺼내지 않고 계속 받기만 한 경우
+        return -1;
+    }
+
+    // 빈 공간이 버퍼 끝에서 처음으로 이어지면 두 조각으로 나눠서 한 번에 읽음
+    iov[0].iov_base = conn->ring + pos;
+    iov[0].iov_len = space;
+    if (pos + space > PROTO_RING_SIZE) {
+        iov[0].iov_len = PROTO_RING_SIZE - pos;
+        iov[1].iov_base = conn->ring;
+        iov[1].iov_len = space - iov[0].iov_len;
+        iovcnt = 2;
+    }
+
+    do {
+        n = readv(conn->fd, iov, iovcnt);
+    } while (n < 0 && errno == EINTR);
+    if (n > 0) {
+        conn->tail += n;
+    }
+    return (int)n;
+}
+
+// ring buffer의 off 위치부터 len 바이트 복사 (버퍼 끝에서 잘린 경우 포함)
+static void ring_copy(const ProtoConn *conn, unsigned int off, void *dst, int len) {
+    unsigned int pos = off & RING_MASK;
+    int first = PROTO_RING_SIZE - pos;
+
+    if (first >= len) {
+        memcpy(dst, conn->ring + pos, len);
+    } else {
+        memcpy(dst, conn->ring + pos, first);
+        memcpy((unsigned char*)dst + first, conn->ring, len - first);
+    }
+}
+
+int proto_next(ProtoConn *conn, ProtoMsg *msg) {
+    unsigned int used = conn->tail - conn->head;
+    unsigned char header[PROTO_HEADER_LEN];
+    unsigned short type, length;
+    unsigned int seq;
+
+    if (used < PROTO_HEADER_LEN) {
+        return 0;
+    }
+    ring_copy(conn, conn->head, header, PROTO_HEADER_LEN);
+    memcpy(&type, header, 2);
+    memcpy(&length, header + 2, 2);
+    memcpy(&seq, header + 4, 4);
+    type = ntohs(type);
+    length = ntohs(length);
+    seq = ntohl(seq);
+
+    if (type == 0 || type >= PROTO_TYPE_MAX || length > PROTO_PAYLOAD_MAX) {
+        fprintf(stderr, "proto : bad header (type %u, length %u)\n", type, length);
+        errno = EPROTO;
+        return -1;
+    }
+    if (used < PROTO_HEADER_LEN + length) {
+        return 0; // payload가 아직 다 오지 않음
+    }
+
+    unsigned int pos = (conn->head + PROTO_HEADER_LEN) & RING_MASK;
+    if (pos + length <= PROTO_RING_SIZE) {
+        msg->payload = conn->ring + pos;
+    } else {
+        ring_copy(conn, conn->head + PROTO_HEADER_LEN, conn->scratch, length);
+        msg->payload = conn->scratch;
+    }
+    msg->type = type;
+    msg->length = length;
+    msg->seq = seq;
+    conn->head += PROTO_HEADER_LEN + length;
+
+    if (seq != conn->rx_seq) {
+        conn->rx_seq_gaps++;
+        fprintf(stderr, "proto : seq %u, expected %u\n", seq, conn->rx_seq);
+    }
+    conn->rx_seq = seq + 1;
+    return 1;
+}
+
+int proto_read(ProtoConn *conn, ProtoMsg *msg) {
+    int ret;
+
+    while ((ret = proto_next(conn, msg)) == 0) {
+        int n = proto_recv(conn);
+        if (n <= 0) {
+            return n;
+        }
+    }
+    return ret;
+}
+
+void proto_queue_attach(ProtoConn *conn, ProtoQueue *q, void (*on_push)(void *arg), void *arg) {
+    memset(q, 0, sizeof(ProtoQueue));
+    q->on_push = on_push;
+    q->arg = arg;
+    conn->txq = q;
+}
+
+// 대기열에서 보내지 않은 메시지 하나를 뺌 (뒤 메시지의 seq를 하나씩 당겨서 받는 쪽 seq가 이어지게)
+static void queue_unlink(ProtoConn *conn, ProtoFrame *prev, ProtoFrame *f) {
+    ProtoQueue *q = conn->txq;
+
+    for (ProtoFrame *next = f->next; next; next = next->next) {
+        unsigned int seq32;
+        memcpy(&seq32, next->data + 4, 4);
+        seq32 = htonl(ntohl(seq32) - 1);
+        memcpy(next->data + 4, &seq32, 4);
+    }
+    conn->tx_seq--;
+
+    if (prev) {
+        prev->next = f->next;
+    } else {
+        q->head = f->next;
+    }
+    if (q->tail == f) {
+        q->tail = prev;
+    }
+    q->bytes -= f->length;
+    free(f);
+}
+
+/***************************************************************************
+ * queue_push(ProtoConn *conn, int type, unsigned char *frame, int total)
+ * seq를 붙여서 대기열 끝에 추가 (tx_lock 잡은 상태)
+ * 아직 보내기 시작하지 않은 SNAPSHOT이 있으면 (HIGH_WATER와 관계없이) 그것을 빼고
+ * 바뀐 값 묶음을 합친 새 SNAPSHOT을 끝에 붙임 (먼저 넣은 REPLY 등을 앞지르지 않음)
+ ***************************************************************************/
+static int queue_push(ProtoConn *conn, int type, unsigned char *frame, int total) {
+    ProtoQueue *q = conn->txq;
+    ProtoFrame *f;
+    int was_empty = q->head == NULL;
+
+    if (type == PROTO_SNAPSHOT) {
+        ProtoFrame *prev = NULL;
+
+        for (f = q->head; f; prev = f, f = f->next) {
+            if (f->type == type && f->length == total && !(f == q->head && q->offset > 0)) {
+                break;
+            }
+        }
+        if (f) {
+            // 첫 바이트는 바뀐 값 묶음이므로 이전 것과 합침
+            frame[PROTO_HEADER_LEN] |= f->data[PROTO_HEADER_LEN];
+            queue_unlink(conn, prev, f);
+            q->merged++;
+        }
+    }
+    if (type == PROTO_PING && q->bytes >= PROTO_QUEUE_HIGH_WATER) {
+        q->dropped++; // 응답이 없으면 heartbeat가 끊긴 노드로 판단
+        return 0;
+    }
+    if (q->bytes + total > PROTO_QUEUE_LIMIT) {
+        errno = ENOBUFS;
+        return -1;
+    }
+
+    f = malloc(sizeof(ProtoFrame) + total);
+    if (f == NULL) {
+        return -1;
+    }
+    unsigned int seq32 = htonl(conn->tx_seq++);
+    memcpy(frame + 4, &seq32, 4);
+    memcpy(f->data, frame, total);
+    f->next = NULL;
+    f->type = type;
+    f->length = total;
+    if (q->tail) {
+        q->tail->next = f;
+    } else {
+        q->head = f;
+    }
+    q->tail = f;
+    q->bytes += total;
+
+    if (was_empty && q->on_push) {
+        q->on_push(q->arg);
+    }
+    return 0;
+}
+
+int proto_queue_flush(ProtoConn *conn) {
+    ProtoQueue *q = conn->txq;
+
+    while (q->head) {
+        struct iovec iov[PROTO_QUEUE_IOV];
+        struct msghdr mh;
+        int count = 0;
+        ssize_t n;
+
+        // 쌓인 메시지를 모아서 한 번에 보냄 (첫 메시지는 보내다 만 곳부터)
+        for (ProtoFrame *f = q->head; f && count < PROTO_QUEUE_IOV; f = f->next, count++) {
+            int skip = count == 0 ? q->offset : 0;
+            iov[count].iov_base = f->data + skip;
+            iov[count].iov_len = f->length - skip;
+        }
+        memset(&mh, 0, sizeof(mh));
+        mh.msg_iov = iov;
+        mh.msg_iovlen = count;
+        // writev와 같지만 끊긴 소켓에서 SIGPIPE가 나지 않도록 sendmsg 사용
+        n = sendmsg(conn->fd, &mh, MSG_NOSIGNAL);
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                return 0;
+            }
+            return -1;
+        }
+
+        // 다 보낸 메시지 해제
+        q->bytes -= n;
+        while (n > 0) {
+            ProtoFrame *f = q->head;
+            int left = f->length - q->offset;
+            if (n < left) {
+                q->offset += n;
+                break;
+            }
+            n -= left;
+            q->offset = 0;
+            q->head = f->next;
+            free(f);
+        }
+        if (q->head == NULL) {
+            q->tail = NULL;
+        }
+    }
+    return 1;
+}
+
+void proto_queue_clear(ProtoConn *conn) {
+    ProtoQueue *q = conn->txq;
+
+    while (q && q->head) {
+        ProtoFrame *f = q->head;
+        q->head = f->next;
+        free(f);
+    }
+    if (q) {
+        q->tail = NULL;
+        q->offset = 0;
+        q->bytes = 0;
+    }
+}
+
+int proto_send(ProtoConn *conn, int type, const void *payload, int length) {
+    unsigned char frame[PROTO_HEADER_LEN + PROTO_PAYLOAD_MAX];
+    unsigned short type16 = htons(type);
+    unsigned short length16 = htons(length);
+    int total = PROTO_HEADER_LEN + length;
+    int sent = 0;
+
+    if (length < 0 || length > PROTO_PAYLOAD_MAX) {
+        errno = EMSGSIZE;
+        return -1;
+    }
+    memcpy(frame, &type16, 2);
+    memcpy(frame + 2, &length16, 2);
+    if (length > 0) {
+        memcpy(frame + PROTO_HEADER_LEN, payload, length);
+    }
+
+    // seq 증가와 전송을 같이 잠가야 받는 쪽에서 순서가 맞음
+    pthread_mutex_lock(&conn->tx_lock);
+    if (conn->fd < 0) {
+        pthread_mutex_unlock(&conn->tx_lock);
+        errno = ENOTCONN; // 다시 연결하는 중
+        return -1;
+    }
+    if (conn->txq) {
+        int ret = queue_push(conn, type, frame, total);
+        pthread_mutex_unlock(&conn->tx_lock);
+        return ret;
+    }
+    unsigned int seq32 = htonl(conn->tx_seq++);
+    memcpy(frame + 4, &seq32, 4);
+    while (sent < total) {
+        ssize_t n = send(conn->fd, frame + sent, total - sent, MSG_NOSIGNAL);
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                // 받는 쪽이 느려서 송신 버퍼가 가득 참, 잠시 기다렸다가 나머지 전송
+                struct pollfd pfd = { .fd = conn->fd, .events = POLLOUT };
+                if (poll(&pfd, 1, PROTO_SEND_TIMEOUT_MS) > 0) {
+                    continue;
+                }
+                errno = ETIMEDOUT;
+            }
+            pthread_mutex_unlock(&conn->tx_lock);
+            perror("proto_send");
+            return -1;
+        }
+        sent += n;
+    }
+    pthread_mutex_unlock(&conn->tx_lock);
+    return 0;
+}
+
+int proto_send_text(ProtoConn *conn, int type, const char *text) {
+    return proto_send(conn, type, text, strlen(text));
+}
+
+int proto_send_op(ProtoConn *conn, int opcode) {
+    return proto_send(conn, opcode, NULL, 0);
+}
+
+int proto_send_hello(ProtoConn *conn, int role) {
+    unsigned char payload[PROTO_HELLO_LEN];
+    const char *node_env = getenv("HOMEFARM_NODE_ID");
+    const char *zone_env = getenv("HOMEFARM_ZONE");
+    unsigned short version16 = htons(PROTO_VERSION);
+    unsigned int node32 = htonl(node_env ? (unsigned int)strtoul(node_env, NULL, 0) : (unsigned int)gethostid());
+
+    memcpy(payload, &version16, 2);
+    payload[2] = role;
+    payload[3] = zone_env ? atoi(zone_env) : 0;
+    memcpy(payload + 4, &node32, 4);
+    return proto_send(conn, PROTO_HELLO, payload, PROTO_HELLO_LEN);
+}
+
+int proto_parse_hello(const ProtoMsg *msg, ProtoHello *hello) {
+    unsigned short version16;
+    unsigned int node32;
+
+    if (msg->type != PROTO_HELLO || msg->length != PROTO_HELLO_LEN) {
+        return -1;
+    }
+    memcpy(&version16, msg->payload, 2);
+    memcpy(&node32, msg->payload + 4, 4);
+    hello->version = ntohs(version16);
+    hello->role = msg->payload[2];
+    hello->zone = msg->payload[3];
+    hello->node_id = ntohl(node32);
+    return 0;
+}
+
+void proto_text(const ProtoMsg *msg, char *buf, int size) {
+    int len = msg->length < size - 1 ? msg->length : size - 1;
+
+    memcpy(buf, msg->payload, len);
+    buf[len] = '\0';
+}
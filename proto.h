@@ -0,0 +1,187 @@
+#ifndef PROTO_H
+#define PROTO_H
+
+#include <pthread.h>
+
+/***************************************************************************
+ * 노드 사이 메시지 형식
+ * TCP는 메시지 경계를 지키지 않으므로 (recv 한 번에 두 메시지가 붙어 오거나
+ * 한 메시지가 나뉘어 옴) 모든 메시지 앞에 헤더를 붙여 보냄
+ *
+ *  | type (2) | length (2) | seq (4) | payload (length) |
+ *
+ * 헤더 값은 모두 network byte order
+ * seq는 연결마다 보내는 쪽이 0부터 1씩 증가시키며, 받는 쪽은 누락/중복 확인에 사용
+ ***************************************************************************/
+#define PROTO_HEADER_LEN 8
+#define PROTO_PAYLOAD_MAX 1024
+#define PROTO_RING_SIZE 4096 // 2의 거듭제곱, 가장 큰 메시지보다 커야 함
+#define PROTO_VERSION 1      // 메시지 형식이 바뀌면 증가 (허브는 같은 버전만 받음)
+
+// 메시지 종류 (헤더의 type, 한 번 정한 번호는 바꾸지 않음)
+typedef enum {
+    PROTO_TEXT = 1,          // 기존 문자열 명령 ("WATER OK" 등, NUL 없음), command_lookup으로 opcode 변환
+    PROTO_REPLY = 2,         // 요청에 대한 문자열 응답 (온도 값, 식물 이름 등)
+    PROTO_PLANT_DATA = 3,    // 사용하지 않음 (식물 상태는 PLANT UPDATE의 PROTO_REPLY로 받음), 번호는 비워둠
+    PROTO_HELLO = 4,         // 연결 직후 노드가 보내는 자기 소개 (ProtoHello)
+    PROTO_SUBSCRIBE = 5,     // 받을 값 묶음 구독 (telemetry.h)
+    PROTO_SNAPSHOT = 6,      // 구독한 값이 바뀌었을 때 허브가 보내는 최신 값 전체
+    PROTO_PING = 7,          // 허브가 주기적으로 보내는 연결 확인 (보낸 시각, heartbeat.h)
+    PROTO_PONG = 8,          // PING에 대한 응답 (받은 내용 그대로)
+    // payload 없는 명령
+    PROTO_LED_ON = 16,
+    PROTO_LED_OFF = 17,
+    PROTO_WATER_LOW = 18,
+    PROTO_WATER_OK = 19,
+    PROTO_GROW_OK = 20,
+    PROTO_TEMP = 21,
+    PROTO_HUMID = 22,
+    PROTO_PLANT_NAME = 23,
+    PROTO_PLANT_DATE = 24,
+    PROTO_PLANT_UPDATE = 25,
+    PROTO_WATER = 26,
+    PROTO_LIGHT_START = 27,
+    PROTO_LIGHT_END = 28,
+    PROTO_TYPE_MAX
+} ProtoType;
+
+// 노드 역할 (메시지를 받는 쪽, 비트 조합으로 사용)
+typedef enum {
+    ROLE_HUB = 1,       // rpi2 : 센서, 명령 중계
+    ROLE_DISPLAY = 2,   // rpi1 : LCD, 버튼
+    ROLE_ACTUATOR = 4   // rpi3 : 물 공급, 조명
+} NodeRole;
+
+/***************************************************************************
+ * 연결 직후 노드가 허브에 처음으로 보내는 메시지 (PROTO_HELLO)
+ * 허브는 이 값으로 연결 순서와 관계없이 노드를 구분함
+ *
+ *  | version (2) | role (1) | zone (1) | node_id (4) |
+ ***************************************************************************/
+#define PROTO_HELLO_LEN 8
+
+typedef struct {
+    int version;           // PROTO_VERSION
+    int role;              // ROLE_DISPLAY, ROLE_ACTUATOR
+    int zone;              // 같은 구역의 노드끼리 알림을 주고받음
+    unsigned int node_id;  // 같은 역할 안에서 노드마다 다른 값
+} ProtoHello;
+
+// 수신한 메시지 (payload는 수신 버퍼를 직접 가리킴)
+typedef struct {
+    int type;
+    unsigned int seq;
+    int length;
+    const unsigned char *payload;
+} ProtoMsg;
+
+/***************************************************************************
+ * 송신 대기열 (허브처럼 non-blocking 소켓을 이벤트 루프에서 쓰는 경우)
+ * proto_send는 메시지를 대기열에 넣기만 하고, 이벤트 루프가 proto_queue_flush로
+ * 쌓인 메시지를 sendmsg 한 번에 모아서 보냄 (다 못 보내면 EPOLLOUT을 기다렸다가 이어서)
+ * 아직 보내지 않은 SNAPSHOT은 쌓인 양과 관계없이 항상 새 SNAPSHOT으로 바뀜 (최신 값만 의미가 있음)
+ * 이전 것은 대기열에서 빼고 새 것을 끝에 붙이므로 메시지 순서는 넣은 순서 그대로이고 seq도 이어짐
+ * 받는 쪽이 느려 HIGH_WATER 이상 쌓이면 PING은 버림
+ ***************************************************************************/
+#define PROTO_QUEUE_HIGH_WATER (16 * 1024)
+#define PROTO_QUEUE_LIMIT (64 * 1024)  // 이보다 많이 쌓이면 전송 실패 (연결을 끊어야 함)
+#define PROTO_QUEUE_IOV 64             // sendmsg 한 번에 보낼 최대 메시지 수
+
+typedef struct ProtoFrame {
+    struct ProtoFrame *next;
+    int type;
+    int length;            // 헤더 포함 길이
+    unsigned char data[];
+} ProtoFrame;
+
+typedef struct ProtoQueue {
+    ProtoFrame *head;
+    ProtoFrame *tail;
+    int offset;            // head에서 이미 보낸 바이트
+    int bytes;             // 아직 보내지 않은 바이트
+    long merged;           // 새 SNAPSHOT으로 바뀐 수
+    long dropped;          // 버린 PING 수
+    void (*on_push)(void *arg); // 비어 있던 대기열에 메시지가 들어오면 호출 (전송 예약용)
+    void *arg;
+} ProtoQueue;
+
+/***************************************************************************
+ * 연결 하나의 송수신 상태
+ * 수신 : recv한 바이트를 ring buffer에 쌓아두고 완성된 메시지만 꺼냄
+ * 송신 : 헤더와 payload를 한 번에 보내며, 여러 스레드가 보내도 메시지가 섞이지 않게 잠금
+ *        (txq가 있으면 대기열에 넣음)
+ ***************************************************************************/
+typedef struct {
+    int fd;
+    unsigned char ring[PROTO_RING_SIZE];
+    unsigned int head;    // 다음에 읽을 위치 (계속 증가, & (PROTO_RING_SIZE - 1) 로 인덱스)
+    unsigned int tail;    // 다음에 쓸 위치
+    unsigned char scratch[PROTO_PAYLOAD_MAX]; // 버퍼 끝에서 잘린 payload를 이어 붙일 곳
+    unsigned int rx_seq;  // 다음에 받을 seq
+    long rx_seq_gaps;     // seq가 어긋난 횟수
+    pthread_mutex_t tx_lock;
+    unsigned int tx_seq;
+    ProtoQueue *txq;      // 송신 대기열 (NULL이면 바로 전송)
+} ProtoConn;
+
+// 연결 상태 초기화 (소켓 연결 후 한 번)
+void proto_conn_init(ProtoConn *conn, int fd);
+
+/***************************************************************************
+ * proto_conn_reset(ProtoConn *conn, int fd)
+ * 다시 연결했을 때 새 소켓으로 바꾸고 버퍼, seq를 처음 상태로 (fd = -1 이면 연결 끊김)
+ * 다른 스레드가 계속 같은 ProtoConn으로 보낼 수 있음 (끊긴 동안에는 ENOTCONN으로 실패)
+ * 수신 스레드가 멈춰 있을 때만 호출
+ ***************************************************************************/
+void proto_conn_reset(ProtoConn *conn, int fd);
+
+/***************************************************************************
+ * proto_recv(ProtoConn *conn)
+ * 소켓에서 읽을 수 있는 만큼 ring buffer의 빈 공간에 읽어 들임 (readv 한 번)
+ * 읽은 바이트 수 반환, 0 = 연결 종료, -1 = 오류
+ * 이전에 proto_next로 꺼낸 메시지의 payload는 이 호출 뒤에 무효가 됨
+ ***************************************************************************/
+int proto_recv(ProtoConn *conn);
+
+/***************************************************************************
+ * proto_next(ProtoConn *conn, ProtoMsg *msg)
+ * 버퍼에 완성된 메시지가 있으면 꺼냄 (1), 더 받아야 하면 0,
+ * 헤더가 잘못되었으면 -1 (더 이상 메시지 경계를 알 수 없으므로 연결을 끊어야 함)
+ * 복사 없이 payload 위치만 알려주므로 recv 한 번에 들어온 여러 메시지를 차례로 꺼낼 수 있음
+ * (버퍼 끝에서 잘린 메시지만 scratch로 복사)
+ ***************************************************************************/
+int proto_next(ProtoConn *conn, ProtoMsg *msg);
+
+// 메시지 하나를 받을 때까지 기다림 (1 = 수신, 0 = 연결 종료, -1 = 오류)
+int proto_read(ProtoConn *conn, ProtoMsg *msg);
+
+// 송신 대기열 사용 시작 (q는 연결이 끝날 때까지 유효해야 함)
+void proto_queue_attach(ProtoConn *conn, ProtoQueue *q, void (*on_push)(void *arg), void *arg);
+
+// 대기열 전송 (1 = 다 보냄, 0 = 소켓 버퍼가 가득 참 (EPOLLOUT 후 다시 호출), -1 = 오류)
+int proto_queue_flush(ProtoConn *conn);
+
+// 보내지 못한 메시지 해제
+void proto_queue_clear(ProtoConn *conn);
+
+// 메시지 전송 (0 = 성공, -1 = 실패)
+int proto_send(ProtoConn *conn, int type, const void *payload, int length);
+int proto_send_text(ProtoConn *conn, int type, const char *text);
+
+// payload 없는 명령 전송
+int proto_send_op(ProtoConn *conn, int opcode);
+
+/***************************************************************************
+ * proto_send_hello(ProtoConn *conn, int role)
+ * 자기 소개 전송, node_id와 zone은 환경변수 HOMEFARM_NODE_ID, HOMEFARM_ZONE
+ * (없으면 gethostid(), 0 구역)
+ ***************************************************************************/
+int proto_send_hello(ProtoConn *conn, int role);
+
+// 받은 HELLO 해석 (0 = 성공, -1 = 길이가 맞지 않음)
+int proto_parse_hello(const ProtoMsg *msg, ProtoHello *hello);
+
+// 문자열 메시지를 NUL로 끝나는 문자열로 복사
+void proto_text(const ProtoMsg *msg, char *buf, int size);
+
+#endif
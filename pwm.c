@@ -0,0 +1,91 @@
+#include "pwm.h"
+#include "hal.h"
+
+// PWM 접근은 모두 현재 HAL 백엔드로 전달
+int PWMExport(int pwmnum) {
+    return hal()->pwm_export(pwmnum);
+}
+
+int PWMUnexport(int pwmnum) {
+    return hal()->pwm_unexport(pwmnum);
+}
+
+int PWMEnable(int pwmnum) {
+    return hal()->pwm_write(pwmnum, "enable", 1);
+}
+
+int PWMDisable(int pwmnum) {
+    return hal()->pwm_write(pwmnum, "enable", 0);
+}
+
+int PWMWritePeriod(int pwmnum, int value) {
+    return hal()->pwm_write(pwmnum, "period", value);
+}
+
+int PWMWriteDutyCycle(int pwmnum, int value) {
+    return hal()->pwm_write(pwmnum, "duty_cycle", value);
+}
+
+// 캐시된 값을 모르는 상태로 되돌림 (쓰기 실패 시 다음 호출에서 다시 쓰도록)
+static void channel_forget(PWMChannel *ch) {
+    ch->period = -1;
+    ch->duty_cycle = -1;
+    ch->enabled = -1;
+}
+
+int PWMChannelOpen(PWMChannel *ch, int pwmnum) {
+    ch->num = pwmnum;
+    channel_forget(ch);
+    return hal()->pwm_export(pwmnum);
+}
+
+int PWMChannelSet(PWMChannel *ch, long period, long duty_cycle) {
+    int ret = 0;
+
+    if (ch->period == period && ch->duty_cycle == duty_cycle) {
+        return 0;
+    }
+
+    // duty_cycle은 항상 period 이하여야 하므로 주기가 줄어들 때는 듀티 사이클을 먼저 씀
+    if (ch->period != -1 && period < ch->period) {
+        if (ch->duty_cycle != duty_cycle) {
+            ret = hal()->pwm_write(ch->num, "duty_cycle", duty_cycle);
+        }
+        if (ret == 0) {
+            ret = hal()->pwm_write(ch->num, "period", period);
+        }
+    } else {
+        if (ch->period != period) {
+            ret = hal()->pwm_write(ch->num, "period", period);
+        }
+        if (ret == 0 && ch->duty_cycle != duty_cycle) {
+            ret = hal()->pwm_write(ch->num, "duty_cycle", duty_cycle);
+        }
+    }
+
+    if (ret == -1) {
+        channel_forget(ch);
+        return -1;
+    }
+    ch->period = period;
+    ch->duty_cycle = duty_cycle;
+    return 0;
+}
+
+int PWMChannelEnable(PWMChannel *ch, int enable) {
+    enable = enable ? 1 : 0;
+    if (ch->enabled == enable) {
+        return 0;
+    }
+    if (hal()->pwm_write(ch->num, "enable", enable) == -1) {
+        ch->enabled = -1;
+        return -1;
+    }
+    ch->enabled = enable;
+    return 0;
+}
+
+void PWMChannelClose(PWMChannel *ch) {
+    hal()->pwm_unexport(ch->num);
+    channel_forget(ch);
+}
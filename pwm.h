@@ -0,0 +1,42 @@
+#ifndef PWM_H
+#define PWM_H
+
+// PWM 채널 시스템에 내보내기
+int PWMExport(int pwmnum);
+
+// PWM 채널 시스템에서 제거
+int PWMUnexport(int pwmnum);
+
+// PWM 활성화, 비활성화
+int PWMEnable(int pwmnum);
+int PWMDisable(int pwmnum);
+
+// PWM 주기, 듀티 사이클 설정 (ns 단위)
+int PWMWritePeriod(int pwmnum, int value);
+int PWMWriteDutyCycle(int pwmnum, int value);
+
+/***************************************************************************
+ * PWM 채널 객체
+ * 마지막으로 쓴 period, duty_cycle, enable 값을 기억해서
+ * 값이 바뀐 속성만 다시 씀 (-1 = 아직 모름, 다음에 반드시 씀)
+ ***************************************************************************/
+typedef struct {
+    int num;
+    long period;
+    long duty_cycle;
+    int enabled;
+} PWMChannel;
+
+// 채널을 내보내고 사용할 준비가 될 때까지 기다림
+int PWMChannelOpen(PWMChannel *ch, int pwmnum);
+
+// 주기와 듀티 사이클 설정 (ns 단위), 바뀐 값만 씀
+int PWMChannelSet(PWMChannel *ch, long period, long duty_cycle);
+
+// 활성화(1), 비활성화(0), 상태가 같으면 쓰지 않음
+int PWMChannelEnable(PWMChannel *ch, int enable);
+
+// 채널 제거
+void PWMChannelClose(PWMChannel *ch);
+
+#endif
@@ -0,0 +1,119 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <errno.h>
+#include <unistd.h>
+
+#include "reactor.h"
+
+#define REACTOR_EVENTS 64 // epoll_wait 한 번에 받을 최대 이벤트 수
+
+typedef struct Deferred {
+    void (*func)(void *arg);
+    void *arg;
+    struct Deferred *next;
+} Deferred;
+
+static int s_epfd = -1;
+static int s_running = 0;
+static Deferred *s_deferred = NULL;
+static Deferred **s_deferred_tail = &s_deferred; // 미룬 순서대로 실행
+
+int reactor_open(void) {
+    s_epfd = epoll_create1(EPOLL_CLOEXEC);
+    if (s_epfd == -1) {
+        perror("Failed to create epoll");
+        return -1;
+    }
+    return 0;
+}
+
+// epoll_ctl 공통 처리
+static int reactor_ctl(int op, ReactorWatch *w, unsigned int events) {
+    struct epoll_event ev;
+
+    ev.events = events;
+    ev.data.ptr = w;
+    if (epoll_ctl(s_epfd, op, w->fd, &ev) == -1) {
+        perror("epoll_ctl");
+        return -1;
+    }
+    return 0;
+}
+
+int reactor_add(ReactorWatch *w, unsigned int events) {
+    return reactor_ctl(EPOLL_CTL_ADD, w, events);
+}
+
+int reactor_mod(ReactorWatch *w, unsigned int events) {
+    return reactor_ctl(EPOLL_CTL_MOD, w, events);
+}
+
+void reactor_del(ReactorWatch *w) {
+    if (w->fd >= 0) {
+        epoll_ctl(s_epfd, EPOLL_CTL_DEL, w->fd, NULL);
+    }
+}
+
+int reactor_defer(void (*func)(void *arg), void *arg) {
+    Deferred *d = malloc(sizeof(Deferred));
+
+    if (d == NULL) {
+        return -1;
+    }
+    d->func = func;
+    d->arg = arg;
+    d->next = NULL;
+    *s_deferred_tail = d;
+    s_deferred_tail = &d->next;
+    return 0;
+}
+
+// 미뤄둔 함수 실행
+static void run_deferred(void) {
+    while (s_deferred) {
+        Deferred *d = s_deferred;
+        s_deferred = d->next;
+        if (s_deferred == NULL) {
+            s_deferred_tail = &s_deferred;
+        }
+        d->func(d->arg);
+        free(d);
+    }
+}
+
+int reactor_run(void) {
+    struct epoll_event events[REACTOR_EVENTS];
+
+    s_running = 1;
+    while (s_running) {
+        int n = epoll_wait(s_epfd, events, REACTOR_EVENTS, -1);
+        if (n == -1) {
+            if (errno == EINTR) {
+                continue;
+            }
+            perror("epoll_wait");
+            return -1;
+        }
+        for (int i = 0; i < n; i++) {
+            ReactorWatch *w = events[i].data.ptr;
+            // 같은 결과 안에서 앞의 처리 함수가 닫은 fd는 건너뜀
+            if (w->fd >= 0) {
+                w->handler(w, events[i].events);
+            }
+        }
+        run_deferred();
+    }
+    return 0;
+}
+
+void reactor_stop(void) {
+    s_running = 0;
+}
+
+void reactor_close(void) {
+    run_deferred();
+    if (s_epfd >= 0) {
+        close(s_epfd);
+        s_epfd = -1;
+    }
+}
@@ -0,0 +1,46 @@
+#ifndef REACTOR_H
+#define REACTOR_H
+
+#include <sys/epoll.h>
+
+typedef struct ReactorWatch ReactorWatch;
+
+// fd에 이벤트(EPOLLIN 등)가 생기면 호출되는 함수
+typedef void (*ReactorHandler)(ReactorWatch *w, unsigned int events);
+
+// 감시할 fd 하나 (사용하는 쪽 구조체 안에 넣어서 사용)
+struct ReactorWatch {
+    int fd;
+    ReactorHandler handler;
+    void *arg;
+};
+
+/***************************************************************************
+ * 이벤트 루프 (epoll)
+ * 스레드 하나가 소켓, timerfd, eventfd를 모두 기다렸다가
+ * 준비된 fd의 처리 함수를 차례로 호출함
+ * 처리 함수는 오래 막히지 않아야 함 (다른 연결의 처리가 늦어짐)
+ ***************************************************************************/
+int reactor_open(void);
+
+// fd 감시 시작/변경/중지
+int reactor_add(ReactorWatch *w, unsigned int events);
+int reactor_mod(ReactorWatch *w, unsigned int events);
+void reactor_del(ReactorWatch *w);
+
+/***************************************************************************
+ * reactor_defer(void (*func)(void *arg), void *arg)
+ * 지금 처리 중인 이벤트를 모두 처리한 뒤에 func 호출
+ * 같은 epoll_wait 결과에 남아있는 이벤트가 해제된 구조체를 가리키지 않도록
+ * 처리 함수 안에서 연결 구조체를 해제할 때 사용
+ * 미룬 순서대로 호출함
+ ***************************************************************************/
+int reactor_defer(void (*func)(void *arg), void *arg);
+
+// reactor_stop이 호출될 때까지 이벤트 처리 (0 = 정상 종료, -1 = 오류)
+int reactor_run(void);
+void reactor_stop(void);
+
+void reactor_close(void);
+
+#endif
@@ -0,0 +1,106 @@
+#include <stdio.h>
+
+#include "registry.h"
+
+// 노드가 맡을 수 있는 역할 (허브는 연결하지 않음)
+#define ROLE_SLOTS 2
+
+static RegistryEntry *s_groups[ROLE_SLOTS][REGISTRY_ZONES];
+static int s_counts[ROLE_SLOTS];
+
+// 역할 비트를 배열 인덱스로 (-1 = 노드가 가질 수 없는 역할)
+static int role_slot(int role) {
+    switch (role) {
+    case ROLE_DISPLAY:
+        return 0;
+    case ROLE_ACTUATOR:
+        return 1;
+    default:
+        return -1;
+    }
+}
+
+int registry_add(RegistryEntry *e) {
+    int slot = role_slot(e->hello.role);
+    int zone = e->hello.zone;
+
+    if (slot < 0 || zone < 0 || zone >= REGISTRY_ZONES) {
+        return -1;
+    }
+    e->prev = NULL;
+    e->next = s_groups[slot][zone];
+    if (e->next) {
+        e->next->prev = e;
+    }
+    s_groups[slot][zone] = e;
+    s_counts[slot]++;
+    return 0;
+}
+
+void registry_remove(RegistryEntry *e) {
+    int slot = role_slot(e->hello.role);
+
+    if (e->prev) {
+        e->prev->next = e->next;
+    } else {
+        s_groups[slot][e->hello.zone] = e->next;
+    }
+    if (e->next) {
+        e->next->prev = e->prev;
+    }
+    e->prev = e->next = NULL;
+    s_counts[slot]--;
+}
+
+RegistryEntry *registry_find(int role, unsigned int node_id) {
+    int slot = role_slot(role);
+
+    if (slot < 0) {
+        return NULL;
+    }
+    for (int zone = 0; zone < REGISTRY_ZONES; zone++) {
+        for (RegistryEntry *e = s_groups[slot][zone]; e; e = e->next) {
+            if (e->hello.node_id == node_id) {
+                return e;
+            }
+        }
+    }
+    return NULL;
+}
+
+int registry_count(int role) {
+    int slot = role_slot(role);
+
+    return slot < 0 ? 0 : s_counts[slot];
+}
+
+void registry_foreach(int role, int zone, RegistryVisit visit, void *arg) {
+    int slot = role_slot(role);
+    int first = zone == ZONE_ALL ? 0 : zone;
+    int last = zone == ZONE_ALL ? REGISTRY_ZONES - 1 : zone;
+
+    if (slot < 0 || first < 0 || last >= REGISTRY_ZONES) {
+        return;
+    }
+    for (int z = first; z <= last; z++) {
+        RegistryEntry *e = s_groups[slot][z];
+        while (e) {
+            RegistryEntry *next = e->next; // visit에서 e가 빠질 수 있음
+            visit(e, arg);
+            e = next;
+        }
+    }
+}
+
+const char *registry_role_name(int role) {
+    switch (role) {
+    case ROLE_HUB:
+        return "hub";
+    case ROLE_DISPLAY:
+        return "display";
+    case ROLE_ACTUATOR:
+        return "actuator";
+    default:
+        return "unknown";
+    }
+}
@@ -0,0 +1,45 @@
+#ifndef REGISTRY_H
+#define REGISTRY_H
+
+#include "proto.h"
+
+#define REGISTRY_ZONES 16   // 허브 하나가 관리하는 구역 수 (HELLO의 zone은 0 ~ 15)
+#define ZONE_ALL -1         // registry_foreach에서 모든 구역
+
+// 등록된 노드 하나 (사용하는 쪽 연결 구조체 안에 넣어서 사용)
+typedef struct RegistryEntry {
+    ProtoHello hello;
+    ProtoConn *conn;
+    int topics;                  // 구독한 값 묶음 (telemetry.h의 TOPIC_*)
+    struct RegistryEntry *prev;  // 같은 역할, 같은 구역의 노드 목록
+    struct RegistryEntry *next;
+} RegistryEntry;
+
+/***************************************************************************
+ * 노드 목록
+ * HELLO로 받은 역할과 구역마다 연결 목록을 따로 두어
+ * 알림을 보낼 때 받을 노드만 차례로 찾음
+ ***************************************************************************/
+
+// 등록 (0 = 성공, -1 = 모르는 역할이거나 구역 범위를 벗어남)
+int registry_add(RegistryEntry *e);
+void registry_remove(RegistryEntry *e);
+
+// 같은 역할, 같은 node_id로 이미 등록된 노드 (재접속 확인용, 없으면 NULL)
+RegistryEntry *registry_find(int role, unsigned int node_id);
+
+// 역할별 등록된 노드 수
+int registry_count(int role);
+
+/***************************************************************************
+ * registry_foreach(int role, int zone, RegistryVisit visit, void *arg)
+ * 역할, 구역(ZONE_ALL = 전체)에 해당하는 노드마다 visit 호출
+ * visit 안에서 그 노드를 registry_remove 해도 됨
+ ***************************************************************************/
+typedef void (*RegistryVisit)(RegistryEntry *e, void *arg);
+void registry_foreach(int role, int zone, RegistryVisit visit, void *arg);
+
+// 역할 이름 (로그 출력용)
+const char *registry_role_name(int role);
+
+#endif
@@ -0,0 +1,225 @@
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+#include <pthread.h>
+#include <arpa/inet.h>
+
+#include "rpc.h"
+#include "heartbeat.h"
+
+#define RPC_ID_LEN 4
+
+// 응답을 기다리는 요청 하나
+typedef struct {
+    int in_use;
+    int done;
+    unsigned int id;
+    int length;
+    unsigned char reply[PROTO_PAYLOAD_MAX]; // rpc_wait 전에 응답이 먼저 올 수 있으므로 여기에 보관
+} RpcPending;
+
+static ProtoConn *s_conn;
+static CommandTable *s_commands;
+static pthread_t s_reader;
+static pthread_mutex_t s_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t s_done;
+static RpcPending s_pending[RPC_PENDING_MAX];
+static unsigned int s_next_id = 1;
+static int s_closed = 0;
+static int s_initialized = 0;
+static long s_late = 0;   // 시간이 지난 뒤에 온 응답 수
+
+// 응답 번호로 기다리는 요청 찾기 (s_lock 잡은 상태)
+static RpcPending *find_pending(unsigned int id) {
+    for (int i = 0; i < RPC_PENDING_MAX; i++) {
+        if (s_pending[i].in_use && s_pending[i].id == id) {
+            return &s_pending[i];
+        }
+    }
+    return NULL;
+}
+
+// 응답을 기다리는 요청에 전달
+static void complete(const ProtoMsg *msg) {
+    unsigned int id32;
+    RpcPending *p;
+
+    if (msg->length < RPC_ID_LEN) {
+        return; // 번호 없는 응답은 누구에게 온 것인지 알 수 없음
+    }
+    memcpy(&id32, msg->payload, RPC_ID_LEN);
+
+    pthread_mutex_lock(&s_lock);
+    p = find_pending(ntohl(id32));
+    if (p && !p->done) {
+        p->length = msg->length - RPC_ID_LEN;
+        memcpy(p->reply, msg->payload + RPC_ID_LEN, p->length);
+        p->done = 1;
+        pthread_cond_broadcast(&s_done);
+    } else {
+        s_late++;
+    }
+    pthread_mutex_unlock(&s_lock);
+}
+
+/***************************************************************************
+ * reader_thread(void *arg)
+ * 수신 스레드, 소켓에서 메시지를 읽어 응답과 명령을 나눔
+ * 연결이 끊어지면 기다리는 요청을 모두 실패로 깨우고 종료
+ ***************************************************************************/
+static void *reader_thread(void *arg) {
+    ProtoMsg msg;
+    int n;
+
+    while ((n = proto_read(s_conn, &msg)) == 1) {
+        if (msg.type == PROTO_REPLY) {
+            complete(&msg);
+        } else if (msg.type == PROTO_PING) {
+            heartbeat_pong(s_conn, &msg);
+        } else if (command_dispatch(s_commands, s_conn, &msg) == -1) {
+            fprintf(stderr, "Invalid command: %s\n", command_name(msg.type));
+        }
+    }
+    if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+        printf("No heartbeat from hub, reconnecting\n"); // SO_RCVTIMEO (client.c)
+    } else if (n < 0) {
+        perror("recv failed");
+    }
+
+    pthread_mutex_lock(&s_lock);
+    s_closed = 1;
+    pthread_cond_broadcast(&s_done);
+    if (s_late > 0) {
+        printf("rpc : %ld late replies dropped\n", s_late);
+    }
+    pthread_mutex_unlock(&s_lock);
+    return NULL;
+}
+
+int rpc_start(ProtoConn *conn, CommandTable *commands) {
+    pthread_condattr_t attr;
+
+    s_conn = conn;
+    s_commands = commands;
+    // 다시 연결할 때마다 호출되므로 조건 변수는 처음 한 번만 만듦
+    // 시간 초과는 시스템 시간이 바뀌어도 영향이 없도록 CLOCK_MONOTONIC 기준
+    if (!s_initialized) {
+        pthread_condattr_init(&attr);
+        pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+        pthread_cond_init(&s_done, &attr);
+        pthread_condattr_destroy(&attr);
+        s_initialized = 1;
+    }
+    pthread_mutex_lock(&s_lock);
+    s_closed = 0;
+    pthread_mutex_unlock(&s_lock);
+
+    if (pthread_create(&s_reader, NULL, reader_thread, NULL) != 0) {
+        perror("Failed to create rpc reader thread");
+        return -1;
+    }
+    return 0;
+}
+
+void rpc_join(void) {
+    pthread_join(s_reader, NULL);
+}
+
+int rpc_begin(int opcode) {
+    RpcPending *p = NULL;
+    unsigned int id, id32;
+
+    pthread_mutex_lock(&s_lock);
+    for (int i = 0; i < RPC_PENDING_MAX && !s_closed; i++) {
+        if (!s_pending[i].in_use) {
+            p = &s_pending[i];
+            break;
+        }
+    }
+    if (p == NULL) {
+        pthread_mutex_unlock(&s_lock);
+        errno = s_closed ? ECONNRESET : EBUSY;
+        return -1;
+    }
+    // 응답이 전송보다 먼저 처리될 수 있으므로 보내기 전에 등록
+    id = s_next_id++;
+    p->in_use = 1;
+    p->done = 0;
+    p->id = id;
+    pthread_mutex_unlock(&s_lock);
+
+    id32 = htonl(id);
+    if (proto_send(s_conn, opcode, &id32, RPC_ID_LEN) == -1) {
+        pthread_mutex_lock(&s_lock);
+        p->in_use = 0;
+        pthread_mutex_unlock(&s_lock);
+        return -1;
+    }
+    return (int)id;
+}
+
+int rpc_wait(int id, char *response, int size, int timeout_ms) {
+    struct timespec deadline;
+    RpcPending *p;
+    int ret = 0;
+
+    clock_gettime(CLOCK_MONOTONIC, &deadline);
+    deadline.tv_sec += timeout_ms / 1000;
+    deadline.tv_nsec += (timeout_ms % 1000) * 1000000L;
+    if (deadline.tv_nsec >= 1000000000L) {
+        deadline.tv_sec++;
+        deadline.tv_nsec -= 1000000000L;
+    }
+
+    pthread_mutex_lock(&s_lock);
+    p = find_pending(id);
+    if (p == NULL) {
+        pthread_mutex_unlock(&s_lock);
+        errno = EINVAL;
+        return -1;
+    }
+    while (!p->done && !s_closed && ret != ETIMEDOUT) {
+        ret = pthread_cond_timedwait(&s_done, &s_lock, &deadline);
+    }
+    if (p->done) {
+        ret = p->length < size - 1 ? p->length : size - 1;
+        memcpy(response, p->reply, ret);
+        response[ret] = '\0';
+    } else {
+        errno = s_closed ? ECONNRESET : ETIMEDOUT;
+        ret = -1;
+    }
+    p->in_use = 0;
+    pthread_mutex_unlock(&s_lock);
+    return ret;
+}
+
+int rpc_call(int opcode, char *response, int size, int timeout_ms) {
+    int id = rpc_begin(opcode);
+
+    if (id == -1) {
+        return -1;
+    }
+    return rpc_wait(id, response, size, timeout_ms);
+}
+
+int rpc_is_request(const ProtoMsg *msg) {
+    return msg->length == RPC_ID_LEN;
+}
+
+int rpc_reply_data(ProtoConn *conn, const ProtoMsg *request, const void *data, int len) {
+    unsigned char payload[PROTO_PAYLOAD_MAX];
+    int id_len = request->length >= RPC_ID_LEN ? RPC_ID_LEN : 0;
+
+    if (len > PROTO_PAYLOAD_MAX - id_len) {
+        len = PROTO_PAYLOAD_MAX - id_len;
+    }
+    memcpy(payload, request->payload, id_len);
+    memcpy(payload + id_len, data, len);
+    return proto_send(conn, PROTO_REPLY, payload, id_len + len);
+}
+
+int rpc_reply(ProtoConn *conn, const ProtoMsg *request, const char *text) {
+    return rpc_reply_data(conn, request, text, strlen(text));
+}
@@ -0,0 +1,56 @@
+#ifndef RPC_H
+#define RPC_H
+
+#include "proto.h"
+#include "command.h"
+
+#define RPC_PENDING_MAX 16     // 동시에 응답을 기다릴 수 있는 요청 수
+#define RPC_TIMEOUT_MS 3000    // 기본 응답 대기 시간
+
+/***************************************************************************
+ * 요청 / 응답
+ * 같은 소켓으로 응답과 허브가 먼저 보내는 명령(WATER LOW 등)이 섞여 오므로
+ * 요청마다 번호를 붙이고 응답에 같은 번호를 붙여 돌려받음
+ *
+ *  요청 :  | request id (4) |
+ *  응답 :  | request id (4) | 응답 내용 | (PROTO_REPLY)
+ *
+ * 수신 스레드 하나가 소켓을 읽어 응답은 기다리는 요청에 전달하고
+ * 나머지 메시지는 명령 테이블로 처리하므로 여러 요청을 한꺼번에 보내고 기다릴 수 있음
+ * 허브의 PING에는 수신 스레드가 바로 PONG으로 응답함
+ ***************************************************************************/
+
+// 수신 스레드 시작 (응답이 아닌 메시지는 commands로 처리, 다시 연결할 때마다 호출)
+int rpc_start(ProtoConn *conn, CommandTable *commands);
+
+// 연결이 끊어져 수신 스레드가 끝날 때까지 기다림
+void rpc_join(void);
+
+/***************************************************************************
+ * rpc_begin(int opcode)
+ * 요청을 보내고 응답을 기다리지 않고 바로 반환 (요청 번호, 실패 시 -1)
+ * 반환한 번호는 rpc_wait로 한 번 기다려야 함
+ ***************************************************************************/
+int rpc_begin(int opcode);
+
+/***************************************************************************
+ * rpc_wait(int id, char *response, int size, int timeout_ms)
+ * 요청의 응답을 NUL로 끝나는 문자열로 받음
+ * 응답 길이 반환, -1 = 시간 초과(ETIMEDOUT) 또는 연결 끊어짐(ECONNRESET)
+ * 시간이 지난 뒤에 온 응답은 버림
+ ***************************************************************************/
+int rpc_wait(int id, char *response, int size, int timeout_ms);
+
+// 요청 하나를 보내고 응답을 기다림 (rpc_begin + rpc_wait)
+int rpc_call(int opcode, char *response, int size, int timeout_ms);
+
+// 허브 쪽 : 요청 번호만 들어 있는 메시지인지 (rpc_begin으로 보낸 요청, 응답을 기다리는 쪽이 있음)
+int rpc_is_request(const ProtoMsg *msg);
+
+// 허브 쪽 : 받은 요청에 같은 번호로 응답 (번호 없는 요청이면 내용만 보냄)
+int rpc_reply(ProtoConn *conn, const ProtoMsg *request, const char *text);
+
+// 문자열이 아닌 응답 (PlantData 인코딩 등, rpc_wait는 반환한 길이만큼 읽어야 함)
+int rpc_reply_data(ProtoConn *conn, const ProtoMsg *request, const void *data, int len);
+
+#endif
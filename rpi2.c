@@ -1,3 +1,5 @@
+#define _GNU_SOURCE
+
 #include <stdio.h>
 #include <stdlib.h>
 #include <unistd.h>
@@ -8,61 +10,110 @@
 #include <sys/ioctl.h>
 #include <linux/i2c-dev.h>
 #include <pthread.h>
+#include <errno.h>
+#include <stdint.h>
+#include <stddef.h>
 #include <sys/socket.h>
+#include <sys/timerfd.h>
+#include <sys/eventfd.h>
 #include <arpa/inet.h>
 
+#include "dht.h"
+#include "gpio.h"
+#include "i2c.h"
+#include "input.h"
+#include "lcd.h"
+#include "proto.h"
+#include "command.h"
+#include "display.h"
+#include "heartbeat.h"
+#include "multicast.h"
+#include "reactor.h"
+#include "registry.h"
+#include "rpc.h"
+#include "telemetry.h"
+#include "sensor.h"
+#include "ultrasonic.h"
+#include "worker.h"
+
 // 초음파센서, 온습도센서, 터치센서 핀번호 정의
 #define TOUCH_PIN 9
 #define ECHO_PIN 23
 #define TRIG_PIN 24
 #define DTH_PIN 27
-#define VALUE_MAX 40
-#define DIRECTION_MAX 40
+
+// 터치 후 다시 인식하기까지 무시할 시간
+#define TOUCH_DEBOUNCE_MS 500
 
 // I2C 주소 정의
 #define I2C_ADDR 0x27
-#define LCD_CHR 1 
-#define LCD_CMD 0 
-
-// LCD 정의
-#define LCD_LINE_1 0x80 
-#define LCD_LINE_2 0xC0 
-
-// 비트 정의
-#define LCD_BACKLIGHT 0x08 //On
-#define ENABLE 0b00000100 
 
 // Socket 통신 관련 변수 정의
 #define PORT 2586
 #define MAXLINE 1024
 
+// 하루를 240초로 가정 (10초마다 1시간)
+#define HOUR_SEC 10
+
+// range_worker 명령
+#define RANGE_MEASURE 1
+
 // 전역 변수 정의
 int distance = 0;
 int temp = 0;
 int humid = 0;
 int IsPlantFullyGrown = 0;
 int IsNeedMoreWater = 0;
-int PrevWaterStatus = 0;
+int PrevWaterStatus[REGISTRY_ZONES]; // 구역마다 마지막으로 알린 물 상태 (1 = OK)
 int LEDStatus = 0;
-int lcd_fd = 0;
 
-// 소켓 파일 디스크립터
-int listenfd,connfd, connfd2;
-int client1_connected = 0;
-int client2_connected = 0;
-int client2_sockfd;  
-pthread_mutex_t connection_mutex = PTHREAD_MUTEX_INITIALIZER;
-pthread_cond_t connection_cond = PTHREAD_COND_INITIALIZER;
-
-struct sockaddr_in servaddr, cliaddr, cliaddr2;
-socklen_t clilen, clilen2;
+// 연결 상태
+typedef enum {
+    CONN_HELLO,  // 연결됨, 노드의 HELLO를 기다리는 중 (다른 메시지는 받지 않음)
+    CONN_OPEN,   // 노드 목록에 등록됨, 메시지 송수신 중
+    CONN_CLOSED  // 끊어짐, 이번 이벤트 처리가 끝나면 해제
+} ConnState;
+
+// 연결된 노드 하나
+typedef struct Conn {
+    ReactorWatch watch;
+    ProtoConn proto;
+    ConnState state;
+    RegistryEntry node; // HELLO로 받은 역할, 구역, node_id (CONN_OPEN일 때만 노드 목록에 있음)
+    Heartbeat heartbeat; // 응답 없는 PING 수, RTT 분포
+    ProtoQueue txq;    // 보낼 메시지 (이벤트 루프가 모아서 전송)
+    int want_out;      // 소켓 버퍼가 가득 차서 EPOLLOUT을 기다리는 중
+    char name[32];     // 주소:포트 (로그용)
+    struct Conn *next;
+} Conn;
 
-// 식물 data 구조체 정의
-typedef struct {
-    int temp;
-    int humid;
-    int LEDStatus;
-} PlantData;
+// 소켓 파일 디스크립터
+int listenfd;
+int reserve_fd = -1;       // fd가 모자랄 때 대기 중인 연결을 받아서 닫기 위한 여분 (/dev/null)
+struct sockaddr_in servaddr;
+Conn *conns = NULL;        // 모든 연결 (HELLO 전 포함)
+CommandTable hub_commands; // 받은 명령 처리 함수
+
+// 이벤트 루프가 기다리는 fd
+ReactorWatch listen_watch; // 새 연결
+ReactorWatch day_watch;    // 1시간마다 (timerfd)
+ReactorWatch sensor_watch; // 온습도 측정값 갱신 (eventfd)
+ReactorWatch range_watch;  // 초음파 측정 결과 (eventfd)
+ReactorWatch heartbeat_watch; // 노드 연결 확인 (timerfd)
+int heartbeat_interval_ms; // PING 간격
+int heartbeat_misses;      // 연속으로 이만큼 응답이 없으면 노드가 꺼진 것으로 봄
+McastSender mcast;         // snapshot multicast 채널 (HOMEFARM_MCAST_GROUP이 없으면 사용 안 함)
+
+// 온습도 스레드가 측정한 최신 값 (sensor_watch로 알림)
+pthread_mutex_t sensor_mutex = PTHREAD_MUTEX_INITIALIZER;
+SensorReading sensor_latest;
+
+// 초음파 측정 스레드와 마지막 측정 결과 (range_watch로 알림, sensor_mutex로 보호)
+Worker range_worker;
+RangeResult range_latest;
+
+// 식물 data (telemetry.h)
+PlantData plantData;
 char PlantName[MAXLINE] = "Tomato";
 char PlantDate[MAXLINE] = "2024-06-01";
 
@@ -72,493 +123,683 @@ void error_handling(const char *message) {
     exit(1);
 }
 
-// GPIO 핀을 시스템에 내보내기
-void gpio_export(int pin) {
-    char buffer[3]; // 핀 번호를 저장할 버퍼
-    ssize_t bytes_written; // 쓰여진 바이트 수
-    int fd; // 파일 디스크립터
+/***************************************************************************
+ * broadcast(int role, int zone, int opcode)
+ * 해당 역할, 구역(ZONE_ALL = 전체)의 모든 노드에 명령 전송
+ * 전송에 실패한 연결은 닫음
+ ***************************************************************************/
+void conn_close(Conn *c);
 
-    // GPIO export 파일 열기
-    fd = open("/sys/class/gpio/export", O_WRONLY);
-    if (fd == -1) {
-        // 파일 열기 실패 시 오류 메시지 출력
-        fprintf(stderr, "Failed to open export for writing!\n");
-        return (-1);
-    }
+// 명령 처리 함수가 받은 ProtoConn이 속한 연결
+#define CONN_OF(p) ((Conn*)((char*)(p) - offsetof(Conn, proto)))
 
-    // 핀 번호를 버퍼에 쓰기
-    bytes_written = snprintf(buffer, 3, "%d", pin);
-    write(fd, buffer, bytes_written); // 핀 번호를 export 파일에 쓰기
-    close(fd); // 파일 디스크립터 닫기
-    return 0; // 성공적으로 내보내기 완료
+void send_to_node(RegistryEntry *e, void *arg) {
+    if (proto_send_op(e->conn, *(int*)arg) == -1) {
+        conn_close(CONN_OF(e->conn));
+    }
 }
 
-// GPIO 핀을 시스템에서 제거하기
-void gpio_unexport(int pin) {
-    char buffer[3]; // 핀 번호를 저장할 버퍼
-    ssize_t bytes_written; // 쓰여진 바이트 수
-    int fd; // 파일 디스크립터
-
-    // GPIO unexport 파일 열기
-    fd = open("/sys/class/gpio/unexport", O_WRONLY);
-    if (fd == -1) {
-        fprintf(stderr, "Failed to open unexport for writing!\n");
-        return (-1);
-    }
+void broadcast(int role, int zone, int opcode) {
+    registry_foreach(role, zone, send_to_node, &opcode);
+}
 
-    // 핀 번호를 버퍼에 쓰기
-    bytes_written = snprintf(buffer, 3, "%d", pin);
-    write(fd, buffer, bytes_written); // 핀 번호를 unexport 파일에 쓰기
-    close(fd); // 파일 디스크립터 닫기
-    return 0; // 성공적으로 제거 완료
+/***************************************************************************
+ * publish(int changed)
+ * 바뀐 값 묶음(changed)을 구독한 모든 노드에 최신 값 전체를 보냄
+ * 노드는 받은 값을 저장해두고 필요할 때 허브에 묻지 않고 바로 사용
+ ***************************************************************************/
+typedef struct {
+    Telemetry snapshot;
+    int changed;
+} Publication;
+
+void current_telemetry(Telemetry *t) {
+    t->temp = plantData.temp;
+    t->humid = plantData.humid;
+    t->led = LEDStatus;
+    t->water_low = IsNeedMoreWater;
+    t->grown = IsPlantFullyGrown;
 }
 
-// GPIO 핀의 방향 설정
-void gpio_direction(int pin, const char* dir) {
-    char path[35];
-    snprintf(path, sizeof(path), "/sys/class/gpio/gpio%d/direction", pin);
-    int fd = open(path, O_WRONLY);
-    if (fd < 0) {
-        perror("gpio/direction");
-        return;
+void publish_to_node(RegistryEntry *e, void *arg) {
+    Publication *p = arg;
+
+    if ((e->topics & TOPIC_MULTICAST) && mcast.fd >= 0) {
+        return; // multicast로 받는 노드
+    }
+    if ((e->topics & p->changed) && telemetry_publish(e->conn, &p->snapshot, p->changed) == -1) {
+        conn_close(CONN_OF(e->conn));
     }
-    write(fd, dir, strlen(dir));
-    close(fd);
 }
 
-// GPIO 핀의 값을 읽기
-int gpio_read(int pin) {
-    char path[VALUE_MAX]; // 경로 버퍼
-    char value_str[3]; // 값 문자열 버퍼
-    int fd; // 파일 디스크립터
+void publish(int changed) {
+    Publication p;
 
-    // GPIO 값 파일 경로 설정
-    snprintf(path, VALUE_MAX, "/sys/class/gpio/gpio%d/value", pin);
-    fd = open(path, O_RDONLY); // 값 파일 열기
-    if (fd == -1) {
-        // 파일 열기 실패 시 오류 메시지 출력
-        fprintf(stderr, "Failed to open gpio value for reading!\n");
-        return -1;
-    }
+    current_telemetry(&p.snapshot);
+    p.changed = changed;
+    registry_foreach(ROLE_DISPLAY, ZONE_ALL, publish_to_node, &p);
+    registry_foreach(ROLE_ACTUATOR, ZONE_ALL, publish_to_node, &p);
+    mcast_publish(&mcast, &p.snapshot, changed);
+}
 
-    // 값 읽기
-    if (read(fd, value_str, 3) == -1) {
-        // 값 읽기 실패 시 오류 메시지 출력
-        fprintf(stderr, "Failed to read value!\n");
-        return -1;
+// 상태가 바뀐 경우만 구독한 노드에 알림
+void set_led_status(int status) {
+    if (LEDStatus != status) {
+        LEDStatus = status;
+        publish(TOPIC_LED);
     }
+}
 
-    close(fd); // 파일 디스크립터 닫기
-    return atoi(value_str); // 값을 정수로 변환하여 반환
+void set_water_status(int need_more_water) {
+    if (IsNeedMoreWater != need_more_water) {
+        IsNeedMoreWater = need_more_water;
+        publish(TOPIC_WATER);
+    }
 }
 
-// GPIO 핀의 값을 쓰기
-void gpio_write(int pin, int value) {
-    static const char s_values_str[] = "01"; // 값 문자열
-    char path[VALUE_MAX]; // 경로 버퍼
-    int fd; // 파일 디스크립터
+/***************************************************************************
+ * on_day_timer(ReactorWatch *w, unsigned int events)
+ * 1시간마다 호출되는 타이머 처리 함수
+ * 6시, 12시, 24시에 일조량 관리, 물공급 관리 알림 보냄
+ * 매 시간마다 식물의 성장을 초음파 센서로 확인 (측정은 range_worker, 결과는 on_range_update)
+ ***************************************************************************/
+void on_day_timer(ReactorWatch *w, unsigned int events) {
+    static int hour = 0;
+    uint64_t expirations;
 
-    // GPIO 값 파일 경로 설정
-    snprintf(path, VALUE_MAX, "/sys/class/gpio/gpio%d/value", pin);
-    fd = open(path, O_WRONLY); // 값 파일 열기
-    if (fd == -1) {
-        // 파일 열기 실패 시 오류 메시지 출력
-        fprintf(stderr, "Failed to open gpio value for writing!\n");
-        return -1;
+    if (read(w->fd, &expirations, sizeof(expirations)) != sizeof(expirations)) {
+        return;
     }
+    hour++;
+    printf("현재 시간은 %d시 입니다.  \n ", hour);
+    worker_post(&range_worker, RANGE_MEASURE, 0, 0);
 
-    // 값 쓰기
-    if (write(fd, &s_values_str[LOW == value ? 0 : 1], 1) != 1) {
-        // 값 쓰기 실패 시 오류 메시지 출력
-        fprintf(stderr, "Failed to write value!\n");
-        return -1;
+    if (hour == 6) {
+        printf("오전 %d시 - 일조량 관리 시작\n", hour);
+        broadcast(ROLE_ACTUATOR, ZONE_ALL, PROTO_LIGHT_START);
+    }
+    if (hour == 12) {
+        printf("낮 %d시 - 물 공급 시작\n", hour);
+        broadcast(ROLE_ACTUATOR, ZONE_ALL, PROTO_WATER);
+    }
+    if (hour == 24) {
+        printf("밤 %d시 - 일조량 관리 종료\n", hour);
+        broadcast(ROLE_ACTUATOR, ZONE_ALL, PROTO_LIGHT_END);
+        set_led_status(0);
+        hour = 0;
     }
+}
+
+/***************************************************************************
+ * measure_range(Worker *w, void *arg)
+ * 초음파 측정 스레드 함수
+ * 측정은 에코를 기다리는 동안 수십 ms 걸리므로 이벤트 루프 대신 여기서 측정하고
+ * range_latest에 저장한 뒤 이벤트 루프에 알림
+ ***************************************************************************/
+void measure_range(Worker *w, void *arg) {
+    WorkerCmd cmd;
 
-    close(fd); // 파일 디스크립터 닫기
-    return 0; // 성공적으로 값 쓰기 완료
+    while (1) {
+        if (worker_wait(w, &cmd, -1) == 1 && cmd.type == RANGE_MEASURE) {
+            RangeResult range = ultrasonic_measure();
+            uint64_t one = 1;
+
+            pthread_mutex_lock(&sensor_mutex);
+            range_latest = range;
+            pthread_mutex_unlock(&sensor_mutex);
+            if (write(range_watch.fd, &one, sizeof(one)) != sizeof(one)) {
+                perror("range eventfd write");
+            }
+        }
+    }
 }
 
-// LCD의 ENABLE 비트를 토글하는 함수
-void lcd_toggle_enable(int bits) {
-    usleep(500); // LCD가 명령을 처리할 수 있도록 짧은 지연 시간 추가
-    if (write(lcd_fd, &bits, 1) != 1) { // bits를 LCD에 쓰기
-        perror("lcd_toggle_enable - write 1"); // 쓰기 실패 시 오류 처리
+/***************************************************************************
+ * on_range_update(ReactorWatch *w, unsigned int events)
+ * 초음파 측정이 끝났을 때 호출되는 함수
+ * 식물이 다 자란 경우 다 자란 최초의 한번만 이벤트 발생, 측정에 성공한 경우만 판단
+ ***************************************************************************/
+void on_range_update(ReactorWatch *w, unsigned int events) {
+    static int PlantGrownStatus = 0;
+    uint64_t count;
+    RangeResult range;
 
+    if (read(w->fd, &count, sizeof(count)) != sizeof(count)) {
+        return;
     }
-    bits |= ENABLE; // ENABLE 비트 설정
-    if (write(lcd_fd, &bits, 1) != 1) { // ENABLE 비트를 설정한 후 bits를 다시 쓰기
-        perror("lcd_toggle_enable - write 2"); // 쓰기 실패 시 오류 처리
+    pthread_mutex_lock(&sensor_mutex);
+    range = range_latest;
+    pthread_mutex_unlock(&sensor_mutex);
+
+    if (range.quality != RANGE_OK) {
+        printf("초음파 측정 실패 : %s\n", range_quality_str(range.quality));
+        return;
     }
-    usleep(500); // LCD가 명령을 처리할 수 있도록 짧은 지연 시간 추가
-    bits &= ~ENABLE; // ENABLE 비트 해제
-    if (write(lcd_fd, &bits, 1) != 1) { // ENABLE 비트를 해제한 후 bits를 다시 쓰기
-        perror("lcd_toggle_enable - write 3"); // 쓰기 실패 시 오류 처리
+    distance = (int)range.distance_cm;
+    if (distance < 15 && PlantGrownStatus == 0) {
+        IsPlantFullyGrown = 1;
+        broadcast(ROLE_DISPLAY, ZONE_ALL, PROTO_GROW_OK);
+        publish(TOPIC_GROWTH);
+        PlantGrownStatus = 1;
+        // 이벤트 발생 시 rpi1에 데이터 전송
     }
-    usleep(500); // LCD가 명령을 처리할 수 있도록 짧은 지연 시간 추가
 }
 
-// LCD에 명령 또는 데이터를 보내는 함수
-void lcd_byte(int bits, int mode) {
-    int bits_high = mode | (bits & 0xF0) | LCD_BACKLIGHT; // 상위 4비트를 설정
-    int bits_low = mode | ((bits << 4) & 0xF0) | LCD_BACKLIGHT; // 하위 4비트를 설정
+// rpi3과 rpi1이 처음으로 모두 연결되면 하루 시작
+void start_day_if_ready() {
+    struct itimerspec its;
 
-    if (write(lcd_fd, &bits_high, 1) != 1) { // 상위 4비트를 LCD에 쓰기
-        perror("lcd_byte - write 1"); // 쓰기 실패 시 오류 처리
+    if (day_watch.fd >= 0 || registry_count(ROLE_ACTUATOR) == 0 || registry_count(ROLE_DISPLAY) == 0) {
+        return;
     }
-    lcd_toggle_enable(bits_high); // ENABLE 신호 토글
-
-    if (write(lcd_fd, &bits_low, 1) != 1) { // 하위 4비트를 LCD에 쓰기
-        perror("lcd_byte - write 2"); // 쓰기 실패 시 오류 처리
+    day_watch.fd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    if (day_watch.fd == -1) {
+        error_handling("timerfd creation failed");
     }
-    lcd_toggle_enable(bits_low); // ENABLE 신호 토글
+    memset(&its, 0, sizeof(its));
+    its.it_value.tv_sec = HOUR_SEC;
+    its.it_interval.tv_sec = HOUR_SEC;
+    timerfd_settime(day_watch.fd, 0, &its, NULL);
+    reactor_add(&day_watch, EPOLLIN);
 }
 
-// LCD 초기화 함수
-void lcd_init() { // 초기화 시작 메시지 출력
-    printf("lcd init\n");
-    if ((lcd_fd = open("/dev/i2c-1", O_RDWR)) < 0) { // I2C 버스를 열기
-        perror("Failed to open i2c bus"); // 열기 실패 시 오류 처리
-        exit(1); // 프로그램 종료
-    }
-    if (ioctl(lcd_fd, I2C_SLAVE, I2C_ADDR) < 0) { // I2C 장치 설정
-        perror("Failed to acquire bus access and/or talk to slave"); // 설정 실패 시 오류 처리
-        exit(1); // 프로그램 종료
+/***************************************************************************
+ * on_touch(const InputEvent *event, void *arg)
+ * 터치 edge 콜백 함수
+ * 몇 번 클릭했는지에 따라, 화면을 다르게 표시함
+ ***************************************************************************/
+void on_touch(const InputEvent *event, void *arg) {
+    int *MonitorTHEME = (int*)arg;
+    char buf[LCD_COLS + 1];
+    char buf2[LCD_COLS + 1];
+
+    // 터치된 경우만 처리 (rising edge 이후 HIGH 상태)
+    if (event->value != HIGH) {
+        return;
     }
 
-    // LCD 초기화 명령 전송
-    lcd_byte(0x33, LCD_CMD); // 초기 명령
-    lcd_byte(0x32, LCD_CMD); // 4비트 모드 설정
-    lcd_byte(0x06, LCD_CMD); // 커서 이동 방향 설정
-    lcd_byte(0x0C, LCD_CMD); // 디스플레이 켜기, 커서 끄기
-    lcd_byte(0x28, LCD_CMD); // 4비트 모드, 2라인, 5x7 포맷
-    lcd_byte(0x01, LCD_CMD); // 화면 지우기
-    usleep(500); // 명령 처리 대기
-}
+    (*MonitorTHEME)++;
+
+    if (*MonitorTHEME > 3) *MonitorTHEME = 0;
+    // 화면 스레드에 요청만 넣고 바로 반환 (그리기 전에 다시 터치하면 최신 테마만 그림)
+    switch (*MonitorTHEME) {
+        case 1:
+            printf("**Monitor THEME1 : WATER CONSUME**\n");
+            if (IsNeedMoreWater == 0){
+                display_show_text("Water Is Full", "It's OK", 0); //한줄에 16글자 가능
+            } else if (IsNeedMoreWater == 1){
+                display_show_text("Fill in the", "WATER TANK", 0); //한줄에 16글자 가능
+            }
+            break;
+        case 2:
+            printf("**Monitor THEME2 : TODAY TEMP**\n");
+
+            snprintf(buf, sizeof(buf), "Temp: %.1fC", plantData.temp / 10.0);
+            snprintf(buf2, sizeof(buf2), "Humid: %.1f%%", plantData.humid / 10.0);
+            display_show_text(buf, buf2, 0);
+            break;
+        case 3:
+            printf("**Monitor THEME3 : LED STATE**\n");
+
+            display_show_text("LED STATE", LEDStatus == 1 ? "ON" : "OFF", 0);
+            break;
 
-// LCD에 문자열을 쓰는 함수
-void lcd_string(const char *message) {
-    while (*message) { // 문자열의 끝까지 반복
-        lcd_byte(*(message++), LCD_CHR); // 각 문자를 LCD에 전송
+        default:
+            display_show_text("1 : WaterConsume", "2 : ENV  3 : LED", 0);
+            break;
     }
 }
 
-// LCD 화면을 지우는 함수
-void lcd_clear() {
-    lcd_byte(0x01, LCD_CMD); // 화면 지우기 명령 전송
-    usleep(500); // 명령 처리 대기
+/***************************************************************************
+ * touch_monitor(void* arg)
+ * 터치, LCD 스레드 함수
+ * 터치센서의 rising edge를 poll()로 기다렸다가 on_touch 호출
+ * 터치가 없는 동안에는 깨어나지 않음
+ ***************************************************************************/
+void* touch_monitor(void* arg) {
+    int MonitorTHEME = 0;
+
+    if (input_register(TOUCH_PIN, "rising", TOUCH_DEBOUNCE_MS, on_touch, &MonitorTHEME) == -1) {
+        fprintf(stderr, "Failed to register touch input\n");
+        return NULL;
+    }
+    input_loop();
+    return NULL;
 }
 
 /***************************************************************************
- * delayMicroseconds()
- * 지정된 microsecond초 동안 지연하는 함수
- * 초음파 센서에 사용
+ * read_dht(void* arg)
+ * 온습도센서에서 데이터를 읽어오는 스레드 함수
+ * DHT11 응답을 직접 해석하여 sensor_latest에 저장하고 이벤트 루프에 알림
+ * 측정에 실패하면 원인을 출력하고 센서 최소 간격 뒤에 다시 측정함
  ***************************************************************************/
-void delayMicroseconds(long delay) {
-    struct timespec ts;
-    ts.tv_sec = delay / 1000000;
-    ts.tv_nsec = (delay % 1000000) * 1000;
-    nanosleep(&ts, NULL);
+void* read_dht(void* arg) {
+    // HOMEFARM_DHT_HELPER 가 있으면 "temp,humid" 줄을 출력하는 외부 명령을 대신 사용
+    char *shell_argv[] = {"/bin/sh", "-c", getenv("HOMEFARM_DHT_HELPER"), NULL};
+    SensorPlugin *sensor = shell_argv[2] ? sensor_helper_create("dht", shell_argv)
+                                         : dht_plugin_create(DTH_PIN, DHT11);
+    SensorReading reading;
+
+    if (sensor == NULL) {
+        perror("Failed to create DHT sensor");
+        return NULL;
+    }
+
+    while (1) {
+        if (sensor_next(sensor, &reading, -1) == 1) {
+            uint64_t one = 1;
+
+            // 값은 이벤트 루프에서 반영 (on_sensor_update)
+            pthread_mutex_lock(&sensor_mutex);
+            sensor_latest = reading;
+            pthread_mutex_unlock(&sensor_mutex);
+            if (write(sensor_watch.fd, &one, sizeof(one)) != sizeof(one)) {
+                perror("sensor eventfd write");
+            }
+        }
+    }
+    return NULL;
 }
 
 /***************************************************************************
- * micros()
- * 시간을 microsecond 단위로 변환하는 함수
- * 초음파 센서에 사용
+ * on_sensor_update(ReactorWatch *w, unsigned int events)
+ * 온습도 스레드가 새 값을 측정했을 때 호출되는 함수
  ***************************************************************************/
-long micros() {
-    struct timespec ts;
-    clock_gettime(CLOCK_MONOTONIC, &ts);
-    return ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+void on_sensor_update(ReactorWatch *w, unsigned int events) {
+    uint64_t count;
+    int temp, humid;
+
+    if (read(w->fd, &count, sizeof(count)) != sizeof(count)) {
+        return;
+    }
+    pthread_mutex_lock(&sensor_mutex);
+    temp = (int)(sensor_latest.temp * 10);
+    humid = (int)(sensor_latest.humid * 10);
+    pthread_mutex_unlock(&sensor_mutex);
+
+    printf("%d %d is WRITTEN BY DHT\n", temp, humid);
+    // 값이 바뀐 경우만 구독한 노드에 알림
+    if (temp != plantData.temp || humid != plantData.humid) {
+        plantData.temp = temp;
+        plantData.humid = humid;
+        publish(TOPIC_ENV);
+    }
 }
 
 /***************************************************************************
- * getDistance()
- * 초음파 센서를 사용하여 식물의 성장을 측정하는 함수
+ * rpi3에서 오는 명령 처리 함수
+ * 조명 상태, 물 부족 상태를 저장하고 물 상태가 바뀌면 rpi1에 알림
+ * 온도, 습도 요청에는 현재 값을 응답함
  ***************************************************************************/
-int getDistance() {
-    long startTime, endTime;
-    float distance;
+void on_led_on(ProtoConn *conn, const ProtoMsg *msg, void *arg) {
+    set_led_status(1);
+    printf("FROM RPI3 ::: LED ON \n");
+}
 
-    // TRIG 핀에 펄스 발생
-    gpio_write(TRIG_PIN, 1);
-    delayMicroseconds(10);
-    gpio_write(TRIG_PIN, 0);
+void on_led_off(ProtoConn *conn, const ProtoMsg *msg, void *arg) {
+    set_led_status(0);
+    printf("FROM RPI3 ::: LED OFF \n");
+}
+
+// 물 상태는 보낸 rpi3과 같은 구역의 rpi1에만 알림
+void on_water_low(ProtoConn *conn, const ProtoMsg *msg, void *arg) {
+    int zone = CONN_OF(conn)->node.hello.zone;
+
+    set_water_status(1);
+    if(PrevWaterStatus[zone] == 1 && IsNeedMoreWater == 1){
+        broadcast(ROLE_DISPLAY, zone, PROTO_WATER_LOW);
+        printf("FROM RPI3 ::: WATER LOW (zone %d)\n", zone);
+        PrevWaterStatus[zone] = 0;
+    }
+}
 
-    // ECHO 핀의 신호 대기
-    while (gpio_read(ECHO_PIN) == 0);
+void on_water_ok(ProtoConn *conn, const ProtoMsg *msg, void *arg) {
+    int zone = CONN_OF(conn)->node.hello.zone;
 
-    // 신호 수신 시간 기록
-    startTime = micros();
+    set_water_status(0);
+    if(PrevWaterStatus[zone] == 0 && IsNeedMoreWater ==0){
+        broadcast(ROLE_DISPLAY, zone, PROTO_WATER_OK);
+        printf("FROM RPI3 ::: WATER OK (zone %d)\n", zone);
+        PrevWaterStatus[zone] = 1;
+    }
+}
 
-    // 신호 수신 종료 시간 기록
-    while (gpio_read(ECHO_PIN) == 1);
-    endTime = micros();
+void on_temp(ProtoConn *conn, const ProtoMsg *msg, void *arg) {
+    char buffer[MAXLINE];
 
-    // 시간 차이 계산
-    float travelTime = (float)(endTime - startTime) / 1000000;
+    snprintf(buffer, MAXLINE, "%d", plantData.temp);
+    rpc_reply(conn, msg, buffer);
+    printf("TO RPI3 ::: send TEMP \n");
+}
 
-    // 거리 계산 (음속: 34300 cm/s)
-    distance = travelTime * 34300 / 2;
+void on_humid(ProtoConn *conn, const ProtoMsg *msg, void *arg) {
+    char buffer[MAXLINE];
 
-    return (int)distance;
+    snprintf(buffer, MAXLINE, "%d", plantData.humid);
+    rpc_reply(conn, msg, buffer);
+    printf("TO RPI3 ::: send HUMID \n");
 }
 
 /***************************************************************************
- * simulate_day(void* arg)
- * 타이머 동작 스레드 함수
- * 6시, 12시, 24시에 일조량 관리, 물공급 관리 알림 보냄
- * 매 시간마다 식물의 성장을 getDistance() 함수로 확인
+ * rpi1에서 오는 요청 처리 함수
+ * 식물 이름, 심은 날짜, 현재 상태(PlantData)를 응답함
  ***************************************************************************/
-void* simulate_day(void* arg) {
-    int sockfd = *(int*)arg;
-    int hour = 0;
-    int PlantGrownStatus = 0;
-    char buffer[MAXLINE];
+void on_plant_name(ProtoConn *conn, const ProtoMsg *msg, void *arg) {
+    rpc_reply(conn, msg, PlantName);
+    printf("TO RPI2 ::: send PlantName \n");
+}
 
-    while (1) { // 하루를 240초로 가정
-        sleep(10);
-        hour++;
-        distance = getDistance();
-        printf("현재 시간은 %d시 입니다.  \n ", hour);
-
-        // 식물이 다 자란 경우
-        // 다 자란 최초의 한번만 이벤트 발생 
-        if (distance <  15 && PlantGrownStatus == 0) {
-            IsPlantFullyGrown = 1;
-            snprintf(buffer, MAXLINE, "Grow OK");
-            send(client2_sockfd, buffer, strlen(buffer), 0);
-            PlantGrownStatus = 1;
-            // 이벤트 발생 시 client2에 데이터 전송
-        }
+void on_plant_date(ProtoConn *conn, const ProtoMsg *msg, void *arg) {
+    rpc_reply(conn, msg, PlantDate);
+    printf("TO RPI2 ::: send PlantDate \n");
+}
 
-        if (hour == 6) {
-            printf("오전 %d시 - 일조량 관리 시작\n", hour);
-            snprintf(buffer, MAXLINE, "LIGHT_START");
-            send(sockfd, buffer, strlen(buffer), 0);
-        }
-        if (hour == 12) {
-            printf("낮 %d시 - 물 공급 시작\n", hour);
-            snprintf(buffer, MAXLINE, "WATER");
-            send(sockfd, buffer, strlen(buffer), 0);
-        }
-        if (hour == 24) {
-            printf("밤 %d시 - 일조량 관리 종료\n", hour);
-            snprintf(buffer, MAXLINE, "LIGHT_END");
-            send(sockfd, buffer, strlen(buffer), 0);
-            LEDStatus = 0;
-            hour = 0;
-        }
+void on_plant_update(ProtoConn *conn, const ProtoMsg *msg, void *arg) {
+    unsigned char payload[PLANT_DATA_MAX];
+    int length;
+
+    printf("TO RPI2 ::: PLANT INFORM UPDATE\n");
+    plantData.led = LEDStatus;
+    plantData.present = PLANT_ALL;
+    // 다른 요청처럼 요청 번호를 붙인 응답 (내용은 PlantData 인코딩)
+    length = plant_data_encode(&plantData, payload, sizeof(payload));
+    if (length > 0) {
+        rpc_reply_data(conn, msg, payload, length);
     }
-    return NULL;
 }
 
 /***************************************************************************
- * touch_monitor(void* arg)
- * 터치, LCD 스레드 함수
- * 터치센서를 사용하여, LCD 모니터를 제어함
- * 몇 번 클릭했는지에 따라, 화면을 다르게 표시함
+ * on_subscribe(ProtoConn *conn, const ProtoMsg *msg, void *arg)
+ * 노드가 받을 값 묶음을 알려옴, 구독 직후 현재 값을 한 번 보냄
  ***************************************************************************/
-void* touch_monitor(void* arg) {
-    int MonitorTHEME = 0;
-    char buf[16];
+void on_subscribe(ProtoConn *conn, const ProtoMsg *msg, void *arg) {
+    RegistryEntry *node = &CONN_OF(conn)->node;
+    Telemetry snapshot;
 
-    while (1) {
-        if (gpio_read(TOUCH_PIN) == 1) {
-            MonitorTHEME++;
-
-            if (MonitorTHEME > 3) MonitorTHEME = 0;
-            lcd_clear();
-            switch (MonitorTHEME) {
-                case 1:
-                    printf("**Monitor THEME1 : WATER CONSUME**\n");
-                    if (IsNeedMoreWater == 0){
-                        lcd_byte(LCD_LINE_1, LCD_CMD);
-                        lcd_string("Water Is Full"); //한줄에 16글자 가능
-                        lcd_byte(LCD_LINE_2, LCD_CMD);
-                        lcd_string("It's OK");
-                    } else if (IsNeedMoreWater == 1){
-                        lcd_byte(LCD_LINE_1, LCD_CMD);
-                        lcd_string("Fill in the"); //한줄에 16글자 가능
-                        lcd_byte(LCD_LINE_2, LCD_CMD);
-                        lcd_string("WATER TANK");
-                    }
-                    break;
-                case 2:
-                    printf("**Monitor THEME2 : TODAY TEMP**\n");
-
-                    snprintf(buf, sizeof(buf), "Temp: %.1fC", PlantData.temp / 10.0);
-                    lcd_byte(LCD_LINE_1, LCD_CMD);
-                    lcd_string(buf);
-
-                    snprintf(buf, sizeof(buf), "Humid: %.1f%%", PlantData.humid / 10.0);
-                    lcd_byte(LCD_LINE_2, LCD_CMD);
-                    lcd_string(buf);
-
-                    break;
-                case 3:
-                    printf("**Monitor THEME3 : LED STATE**\n");
-
-                    lcd_byte(LCD_LINE_1, LCD_CMD);
-                    lcd_string("LED STATE");
-                    if (LEDStatus == 0) {
-                        lcd_byte(LCD_LINE_2, LCD_CMD);
-                        lcd_string("OFF");
-                    } else if (LEDStatus == 1) {
-                        lcd_byte(LCD_LINE_2, LCD_CMD);
-                        lcd_string("ON");
-                    }
-                    break;
-
-                default:
-                    lcd_byte(LCD_LINE_1, LCD_CMD);
-                    lcd_string("1 : WaterConsume");
-                    lcd_byte(LCD_LINE_2, LCD_CMD);
-                    lcd_string("2 : ENV  3 : LED");
-                    break;
-            }
-            usleep(500000);
-        }
-        usleep(10000);
+    if (telemetry_parse_subscribe(msg, &node->topics) == -1) {
+        return;
     }
+    current_telemetry(&snapshot);
+    if (node->topics & TOPIC_ALL) {
+        telemetry_publish(conn, &snapshot, node->topics & TOPIC_ALL);
+    }
+}
+
+// 허브가 받는 명령 등록
+void setup_commands() {
+    command_init(&hub_commands, ROLE_HUB);
+    command_register(&hub_commands, PROTO_LED_ON, on_led_on, NULL);
+    command_register(&hub_commands, PROTO_LED_OFF, on_led_off, NULL);
+    command_register(&hub_commands, PROTO_WATER_LOW, on_water_low, NULL);
+    command_register(&hub_commands, PROTO_WATER_OK, on_water_ok, NULL);
+    command_register(&hub_commands, PROTO_TEMP, on_temp, NULL);
+    command_register(&hub_commands, PROTO_HUMID, on_humid, NULL);
+    command_register(&hub_commands, PROTO_PLANT_NAME, on_plant_name, NULL);
+    command_register(&hub_commands, PROTO_PLANT_DATE, on_plant_date, NULL);
+    command_register(&hub_commands, PROTO_PLANT_UPDATE, on_plant_update, NULL);
+    command_register(&hub_commands, PROTO_SUBSCRIBE, on_subscribe, NULL);
 }
 
 /***************************************************************************
- * socket_communication()
- * 온습도센서에서 데이터를 읽어오는 함수
- * read_dht.py 파일에서 온습도를 측정하고, 데이터를 읽어와 temp, humid에 저장함
+ * 연결 관리
+ * 노드마다 Conn 하나, 모든 소켓은 non-blocking으로 이벤트 루프에서 처리
+ * 노드는 연결 직후 HELLO로 역할, 구역, node_id를 알려야 하며
+ * 그 뒤에야 노드 목록에 등록되어 명령을 주고받음 (연결 순서와 무관)
+ * 보내는 메시지는 연결마다 대기열에 쌓았다가 이벤트 처리가 끝난 뒤 한 번에 보냄
+ * (느린 노드 때문에 이벤트 루프가 막히지 않음, 너무 많이 쌓이면 연결을 끊음)
  ***************************************************************************/
-void* read_dht(void* arg) {
-    while (1) {
-        FILE *fp = popen("python3 read_dht.py", "r");
-        if (fp == NULL) {
-            perror("Failed to RUN SCRIPT");
-            exit(1);
-        }
+void conn_free(void *arg) {
+    Conn *c = arg;
 
-        char result[100];
-        if (fgets(result, sizeof(result), fp) != NULL) {
-            float temperature = 0.0, humidity = 0.0;
-            int matched = sscanf(result, "%f,%f", &temperature, &humidity);
-            if (matched == 2) {
-                //printf("Temperature: %.1f C, Humidity: %.1f %%\n", temperature, humidity);
-                PlantData.temp = (int)(temperature * 10);
-                PlantData.humid = (int)(humidity * 10);
+    proto_queue_clear(&c->proto);
+    pthread_mutex_destroy(&c->proto.tx_lock);
+    free(c);
+}
 
-                printf("%d %d is WRITTEN BY PYTHON SCRIPT\n", PlantData.temp, PlantData.humid);
-            } else {
-                printf("Failed to sensor data\n");
-            }
-        } else {
-            printf("Failed to read data from Python script\n");
-        }
+void conn_close(Conn *c) {
+    Conn **pp;
 
-        pclose(fp);
-        usleep(200000);
+    if (c->state == CONN_CLOSED) {
+        return;
+    }
+    if (c->state == CONN_OPEN) {
+        heartbeat_print(&c->heartbeat, c->name);
+    }
+    if (c->txq.merged || c->txq.dropped) {
+        printf("%s : %ld snapshots merged, %ld pings dropped (slow reader)\n", c->name, c->txq.merged, c->txq.dropped);
+    }
+    c->state = CONN_CLOSED;
+    printf("Connection closed %s\n", c->name);
+
+    reactor_del(&c->watch);
+    // 다른 곳에 남은 ProtoConn 참조로 보내도 닫힌 (다시 쓰일 수 있는) fd나 해제될 대기열을 쓰지 않고 ENOTCONN으로 실패
+    pthread_mutex_lock(&c->proto.tx_lock);
+    proto_queue_clear(&c->proto);
+    c->proto.txq = NULL;
+    c->proto.fd = -1;
+    pthread_mutex_unlock(&c->proto.tx_lock);
+    close(c->watch.fd);
+    c->watch.fd = -1;
+    for (pp = &conns; *pp; pp = &(*pp)->next) {
+        if (*pp == c) {
+            *pp = c->next;
+            break;
         }
+    }
+    if (c->node.conn) {
+        registry_remove(&c->node);
+    }
+    // 같은 epoll_wait 결과에 이 연결의 이벤트가 남아있을 수 있으므로 나중에 해제
+    reactor_defer(conn_free, c);
 }
 
 /***************************************************************************
- * socket_communication_client1(void* arg)
- * rpi3과 소켓 통신을 통해 명령을 수신하고 처리하는 함수
- * 명령 수신에 따라 각각의 기능 작동
+ * conn_flush(void *arg)
+ * 쌓인 메시지 전송, 처리 중인 이벤트가 끝난 뒤 한 번에 보내도록 reactor_defer로 호출
+ * 소켓 버퍼가 가득 차면 EPOLLOUT을 기다렸다가 나머지를 보냄
  ***************************************************************************/
-void* socket_communication_client1(void* arg) {
-    int sockfd = *(int*)arg;
-    char buffer[MAXLINE];
-    int n;
+void conn_flush(void *arg) {
+    Conn *c = arg;
+    int ret;
 
-    while (1) {
-        n = recv(sockfd, buffer, MAXLINE - 1, 0);
-        if (n < 0) {
-            perror("recv failed");
-            break;
+    if (c->state == CONN_CLOSED) {
+        return;
+    }
+    ret = proto_queue_flush(&c->proto);
+    if (ret == -1) {
+        perror("send failed");
+        conn_close(c);
+    } else if (ret == 0 && !c->want_out) {
+        c->want_out = 1;
+        reactor_mod(&c->watch, EPOLLIN | EPOLLOUT);
+    } else if (ret == 1 && c->want_out) {
+        c->want_out = 0;
+        reactor_mod(&c->watch, EPOLLIN);
+    }
+}
+
+// 비어 있던 송신 대기열에 메시지가 들어옴 (EPOLLOUT을 기다리는 중이면 그때 보냄)
+void on_conn_push(void *arg) {
+    Conn *c = arg;
+
+    if (!c->want_out) {
+        reactor_defer(conn_flush, c);
+    }
+}
+
+/***************************************************************************
+ * conn_hello(Conn *c, const ProtoMsg *msg)
+ * 연결의 첫 메시지 처리, HELLO가 아니거나 버전이 다르면 연결을 끊음
+ * 같은 역할, 같은 node_id의 이전 연결이 남아있으면 (재부팅 등) 이전 연결을 닫고 교체
+ ***************************************************************************/
+void conn_hello(Conn *c, const ProtoMsg *msg) {
+    RegistryEntry *old;
+
+    if (proto_parse_hello(msg, &c->node.hello) == -1) {
+        printf("%s : expected HELLO, got %s\n", c->name, command_name(msg->type));
+        conn_close(c);
+        return;
+    }
+    if (c->node.hello.version != PROTO_VERSION) {
+        printf("%s : protocol version %d, hub is %d\n", c->name, c->node.hello.version, PROTO_VERSION);
+        conn_close(c);
+        return;
+    }
+    old = registry_find(c->node.hello.role, c->node.hello.node_id);
+    if (old) {
+        printf("%s : node %u reconnected, replacing %s\n", c->name, c->node.hello.node_id, CONN_OF(old->conn)->name);
+        conn_close(CONN_OF(old->conn));
+    }
+    c->node.conn = &c->proto;
+    if (registry_add(&c->node) == -1) {
+        printf("%s : invalid role %d / zone %d\n", c->name, c->node.hello.role, c->node.hello.zone);
+        c->node.conn = NULL;
+        conn_close(c);
+        return;
+    }
+    c->state = CONN_OPEN;
+    printf("Node %s %u (zone %d) at %s\n", registry_role_name(c->node.hello.role),
+           c->node.hello.node_id, c->node.hello.zone, c->name);
+    start_day_if_ready();
+}
+
+// 소켓에서 읽은 메시지를 모두 처리
+void on_conn_event(ReactorWatch *w, unsigned int events) {
+    Conn *c = w->arg;
+    ProtoMsg msg;
+    int ret;
+
+    if (events & EPOLLOUT) {
+        conn_flush(c);
+        if (c->state == CONN_CLOSED) {
+            return;
         }
-        buffer[n] = '\0';
-
-        if (strcmp(buffer, "LED ON") == 0) {
-            LEDStatus = 1;
-            printf("FROM RPI3 ::: LED ON \n");
-        } else if (strcmp(buffer, "LED OFF") == 0) {
-            LEDStatus = 0;
-            printf("FROM RPI3 ::: LED OFF \n");
-
-        } else if (strcmp(buffer, "WATER LOW") == 0) {
-            IsNeedMoreWater = 1;
-            if(PrevWaterStatus == 1 && IsNeedMoreWater == 1){
-                snprintf(buffer, MAXLINE, "WATER LOW");
-                send(client2_sockfd, buffer, strlen(buffer), 0);
-                printf("FROM RPI3 ::: WATER LOW \n");
-                PrevWaterStatus = 0;
+    }
+    if (events & (EPOLLIN | EPOLLHUP | EPOLLERR)) {
+        int n = proto_recv(&c->proto);
+        if (n == 0 || (n < 0 && errno != EAGAIN)) {
+            if (n < 0) {
+                perror("recv failed");
             }
+            conn_close(c);
+            return;
+        }
+    }
 
-        } else if (strcmp(buffer, "WATER OK") == 0) {
-            IsNeedMoreWater = 0;
-            if(PrevWaterStatus == 0 && IsNeedMoreWater ==0){
-                snprintf(buffer, MAXLINE, "WATER OK");
-                send(client2_sockfd, buffer, strlen(buffer), 0);
-                printf("FROM RPI3 ::: WATER OK \n");
-                PrevWaterStatus = 1;
+    // recv 한 번에 여러 메시지가 들어와도 메시지 단위로 하나씩 처리
+    while (c->state != CONN_CLOSED && (ret = proto_next(&c->proto, &msg)) == 1) {
+        if (c->state == CONN_HELLO) {
+            conn_hello(c, &msg);
+        } else if (msg.type == PROTO_PONG) {
+            heartbeat_receive(&c->heartbeat, &msg);
+        } else if (command_dispatch(&hub_commands, &c->proto, &msg) == -1) {
+            // 기다리는 요청에만 응답, 나머지는 응답해도 받을 곳이 없으므로 버림
+            if (rpc_is_request(&msg)) {
+                rpc_reply(&c->proto, &msg, "UNKNOWN REQUEST");
+            } else {
+                printf("%s : unexpected %s (%d bytes) dropped\n", c->name, command_name(msg.type), msg.length);
             }
-        } 
-        else if (strcmp(buffer, "TEMP") == 0) {
-            snprintf(buffer, MAXLINE, "%d", PlantData.temp);
-            send(sockfd, buffer, strlen(buffer), 0);
-            printf("TO RPI3 ::: send TEMP \n");
-
-        } else if (strcmp(buffer, "HUMID") == 0) {
-            snprintf(buffer, MAXLINE, "%d", PlantData.humid);
-            send(sockfd, buffer, strlen(buffer), 0);
-            printf("TO RPI3 ::: send HUMID \n");
-        }
-        else {
-            snprintf(buffer, MAXLINE, "UNKNOWN REQUEST");
-            send(sockfd, buffer, strlen(buffer), 0);
         }
     }
-
-    close(sockfd);
-    return NULL;
+    if (c->state != CONN_CLOSED && ret == -1) {
+        conn_close(c); // 메시지 경계를 잃어버림
+    }
 }
 
 /***************************************************************************
- * socket_communication_client2(void* arg)
- * rpi1과 소켓 통신을 통해 명령을 수신하고 처리하는 함수
- * 명령 수신에 따라 각각의 기능 작동
+ * on_heartbeat_timer(ReactorWatch *w, unsigned int events)
+ * heartbeat 간격마다 호출, 모든 노드에 PING 전송
+ * 연속으로 heartbeat_misses번 응답(PONG)이 없는 노드는 꺼진 것으로 보고 연결을 닫음
+ * HELLO를 보내지 않고 연결만 유지하는 소켓도 같은 시간이 지나면 닫음
+ * multicast 채널에는 마지막 snapshot을 다시 보냄 (빠진 datagram을 노드가 알 수 있게)
  ***************************************************************************/
-void* socket_communication_client2(void* arg) {
-    int sockfd = *(int*)arg;
-    char buffer[MAXLINE];
-    int n;
+void on_heartbeat_timer(ReactorWatch *w, unsigned int events) {
+    uint64_t expirations;
+    Conn *c = conns;
 
-    while (1) {
-        n = recv(sockfd, buffer, MAXLINE - 1, 0);
-        if (n < 0) {
-            perror("recv failed");
+    if (read(w->fd, &expirations, sizeof(expirations)) != sizeof(expirations)) {
+        return;
+    }
+    while (c) {
+        Conn *next = c->next;
+        if (c->heartbeat.missed >= heartbeat_misses) {
+            printf("Node %s is dead (%d heartbeats missed)\n", c->name, c->heartbeat.missed);
+            conn_close(c);
+        } else if (c->state == CONN_HELLO) {
+            c->heartbeat.missed++;
+        } else if (heartbeat_ping(&c->proto, &c->heartbeat) == -1) {
+            conn_close(c);
+        }
+        c = next;
+    }
+    mcast_repeat(&mcast);
+}
+
+/***************************************************************************
+ * shed_connections(int fd)
+ * fd가 모자라 accept가 EMFILE / ENFILE로 실패할 때 호출
+ * 대기 중인 연결은 계속 listen 소켓을 읽을 수 있는 상태로 만들어서 (level-triggered)
+ * 그대로 두면 이벤트 루프가 쉬지 않고 on_accept를 부르므로
+ * 여분 fd를 잠시 닫고 연결을 받아서 바로 닫음 (노드는 다시 연결을 시도함)
+ ***************************************************************************/
+void shed_connections(int fd) {
+    int shed = 0;
+
+    while (reserve_fd >= 0) {
+        close(reserve_fd);
+        int c = accept4(fd, NULL, NULL, SOCK_CLOEXEC);
+        if (c >= 0) {
+            close(c);
+            shed++;
+        }
+        reserve_fd = open("/dev/null", O_RDONLY | O_CLOEXEC);
+        if (c < 0) {
             break;
         }
-        buffer[n] = '\0';
-        if (strcmp(buffer, "PlantName") == 0) {
-            snprintf(buffer, MAXLINE, PlantName);
-            send(sockfd, buffer, strlen(buffer), 0);
-            printf("TO RPI2 ::: send PlantName \n");
-
-        } else if (strcmp(buffer, "PlantDate") == 0) {
-            snprintf(buffer, MAXLINE, PlantDate);
-            send(sockfd, buffer, strlen(buffer), 0);
-            printf("TO RPI2 ::: send PlantDate \n");
-
-        } else if (strcmp(buffer, "PLANT UPDATE") == 0) {
-            printf("TO RPI2 ::: PLANT INFORM UPDATE\n");
-            PlantData.LEDStatus = LEDStatus;
-            send(sockfd, "PLANT DATA", strlen("PLANT DATA"), 0);
-            send(sockfd, &PlantData, sizeof(PlantData), 0);
-        } else {
-            snprintf(buffer, MAXLINE, "UNKNOWN REQUEST");
-            send(sockfd, buffer, strlen(buffer), 0);
+    }
+    if (shed) {
+        printf("Out of file descriptors, %d connections refused\n", shed);
+    }
+    if (reserve_fd < 0) {
+        perror("reserve fd");
+    }
+}
+
+// 새 연결 수락 (한 번에 여러 개가 들어와 있을 수 있음)
+void on_accept(ReactorWatch *w, unsigned int events) {
+    struct sockaddr_in addr;
+    socklen_t addrlen = sizeof(addr);
+    int fd;
+
+    while ((fd = accept4(w->fd, (struct sockaddr*)&addr, &addrlen, SOCK_NONBLOCK | SOCK_CLOEXEC)) >= 0) {
+        Conn *c = calloc(1, sizeof(Conn));
+        if (c == NULL) {
+            close(fd);
+            continue;
+        }
+        proto_conn_init(&c->proto, fd);
+        proto_queue_attach(&c->proto, &c->txq, on_conn_push, c);
+        heartbeat_tune_socket(fd, heartbeat_interval_ms, heartbeat_misses);
+        c->state = CONN_HELLO;
+        snprintf(c->name, sizeof(c->name), "%s:%d", inet_ntoa(addr.sin_addr), ntohs(addr.sin_port));
+        c->watch.fd = fd;
+        c->watch.handler = on_conn_event;
+        c->watch.arg = c;
+        if (reactor_add(&c->watch, EPOLLIN) == -1) {
+            conn_free(c);
+            close(fd);
+            continue;
         }
+        c->next = conns;
+        conns = c;
+        printf("Connection accepted from %s\n", c->name);
+        addrlen = sizeof(addr);
+    }
+    if (errno == EMFILE || errno == ENFILE) {
+        shed_connections(w->fd);
+    } else if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+        perror("accept failed");
     }
-    close(sockfd);
-    return NULL;
 }
 
 /***************************************************************************
@@ -566,15 +807,16 @@ void* socket_communication_client2(void* arg) {
  * 사용할 GPIO 핀과 LCD를 초기화하는 함수
  ***************************************************************************/
 void setup() {
-    gpio_export(TRIG_PIN);
-    gpio_export(ECHO_PIN);
-    gpio_export(TOUCH_PIN);
-    gpio_direction(TRIG_PIN, "out");
-    gpio_direction(ECHO_PIN, "in");
-    gpio_direction(TOUCH_PIN, "in");
-    gpio_write(TRIG_PIN, 0);
+    GPIOExport(TOUCH_PIN);
+    GPIODirection(TOUCH_PIN, IN);
+    // ECHO 핀은 sysfs 대신 캐릭터 디바이스 라인 이벤트로 사용
+    if (ultrasonic_open(TRIG_PIN, ECHO_PIN) == -1) {
+        fprintf(stderr, "Failed to open ultrasonic sensor\n");
+    }
     usleep(500000); // 0.5초 대기
-    lcd_init();
+    if (lcd_init(1, I2C_ADDR) == -1 || display_start() == -1) {
+        error_handling("lcd init failed");
+    }
 }
 /***************************************************************************
  * main()
@@ -582,12 +824,22 @@ void setup() {
  * rpi1과 rpi3이 모두 연결되어야 다음으로 넘어감
  ***************************************************************************/
 int main() {
+    pthread_t touch_change_monitor_thread, dht_thread;
+    struct itimerspec its;
+    int on = 1;
+
     setup();
-    pthread_t touch_change_monitor_thread, dht_thread, simulate_day_thread, client_thread1, client_thread2;
-    listenfd = socket(AF_INET, SOCK_STREAM, 0);
+    setup_commands();
+    if (reactor_open() == -1) {
+        error_handling("reactor creation failed");
+    }
+
+    listenfd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
     if (listenfd < 0) {
         error_handling("socket creation failed");
     }
+    // 허브를 다시 시작할 때 이전 연결의 TIME_WAIT 때문에 bind가 실패하지 않도록
+    setsockopt(listenfd, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on));
 
     memset(&servaddr, 0, sizeof(servaddr));
     servaddr.sin_family = AF_INET;
@@ -598,63 +850,62 @@ int main() {
         error_handling("bind failed");
     }
 
-    if (listen(listenfd, 5) < 0) {
+    if (listen(listenfd, SOMAXCONN) < 0) {
         error_handling("listen failed");
     }
     printf("Server listening on port %d\n", PORT);
+    reserve_fd = open("/dev/null", O_RDONLY | O_CLOEXEC);
+
+    // 새 연결, 온습도 갱신, 노드 연결 확인은 이벤트 루프에서 처리 (하루 타이머는 rpi1, rpi3이 연결된 뒤 시작)
+    listen_watch.fd = listenfd;
+    listen_watch.handler = on_accept;
+    day_watch.fd = -1;
+    day_watch.handler = on_day_timer;
+    sensor_watch.fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    sensor_watch.handler = on_sensor_update;
+    range_watch.fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    range_watch.handler = on_range_update;
+    if (sensor_watch.fd == -1 || range_watch.fd == -1) {
+        error_handling("eventfd creation failed");
+    }
+    heartbeat_config(&heartbeat_interval_ms, &heartbeat_misses);
+    mcast_sender_open(&mcast);
+    heartbeat_watch.fd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    heartbeat_watch.handler = on_heartbeat_timer;
+    if (heartbeat_watch.fd == -1) {
+        error_handling("timerfd creation failed");
+    }
+    memset(&its, 0, sizeof(its));
+    its.it_value.tv_sec = heartbeat_interval_ms / 1000;
+    its.it_value.tv_nsec = heartbeat_interval_ms % 1000 * 1000000L;
+    its.it_interval = its.it_value;
+    timerfd_settime(heartbeat_watch.fd, 0, &its, NULL);
+    if (reactor_add(&listen_watch, EPOLLIN) == -1 || reactor_add(&sensor_watch, EPOLLIN) == -1 ||
+        reactor_add(&range_watch, EPOLLIN) == -1 || reactor_add(&heartbeat_watch, EPOLLIN) == -1) {
+        error_handling("reactor add failed");
+    }
 
-    // 첫 번째 클라이언트 연결 (192.168.91.20)
-    clilen = sizeof(cliaddr);
-    connfd = accept(listenfd, (struct sockaddr*)&cliaddr, &clilen);
-    if (connfd < 0) {
-        error_handling("accept failed");
-    }
-    printf("Connection accepted from %s:%d\n", inet_ntoa(cliaddr.sin_addr), ntohs(cliaddr.sin_port));
-    pthread_mutex_lock(&connection_mutex);
-    client1_connected = 1;
-    pthread_cond_signal(&connection_cond);
-    pthread_mutex_unlock(&connection_mutex);
-    pthread_create(&client_thread1, NULL, socket_communication_client1, &connfd);
-
-    // 두 번째 클라이언트 연결 (192.168.91.13)
-    clilen2 = sizeof(cliaddr2);
-    connfd2 = accept(listenfd, (struct sockaddr*)&cliaddr2, &clilen2);
-    if (connfd2 < 0) {
-        error_handling("accept failed");
-    }
-    printf("Connection accepted from %s:%d\n", inet_ntoa(cliaddr2.sin_addr), ntohs(cliaddr2.sin_port));
-    // client2의 소켓 파일 디스크립터 저장
-    client2_sockfd = connfd2;  
-    pthread_mutex_lock(&connection_mutex);
-    client2_connected = 1;
-    pthread_cond_signal(&connection_cond);
-    pthread_mutex_unlock(&connection_mutex);
-    pthread_create(&client_thread2, NULL, socket_communication_client2, &connfd2);
-
-    // 두 클라이언트가 모두 연결될때까지 대기
-    pthread_mutex_lock(&connection_mutex);
-    while (client1_connected == 0 || client2_connected == 0) {
-        pthread_cond_wait(&connection_cond, &connection_mutex);
-    }
-    pthread_mutex_unlock(&connection_mutex);
-
-    pthread_create(&simulate_day_thread, NULL, simulate_day, &connfd);
     pthread_create(&touch_change_monitor_thread, NULL, touch_monitor, NULL);
     pthread_create(&dht_thread, NULL, read_dht, NULL);
+    worker_start(&range_worker, "range", measure_range, NULL);
+
+    reactor_run();
 
-    pthread_join(simulate_day_thread, NULL);
-    pthread_join(touch_change_monitor_thread, NULL);
-    pthread_join(dht_thread, NULL);
-    pthread_join(client_thread1, NULL);
-    pthread_join(client_thread2, NULL);
+    while (conns) {
+        conn_close(conns);
+    }
+    reactor_close();
+    mcast_sender_close(&mcast);
 
-    gpio_unexport(TRIG_PIN);
-    gpio_unexport(ECHO_PIN);
-    gpio_unexport(TOUCH_PIN);
-    gpio_unexport(DTH_PIN);
+    ultrasonic_close();
+    GPIOUnexport(TOUCH_PIN);
 
-    close(lcd_fd);
+    display_stop();
+    lcd_close();
     close(listenfd);
+    if (reserve_fd >= 0) {
+        close(reserve_fd);
+    }
 
     return 0;
-}
\ No newline at end of file
+}
@@ -6,8 +6,19 @@
 #include <pthread.h>
 #include <sys/socket.h>
 #include <arpa/inet.h>
+#include <signal.h>
 #include <time.h>
 
+#include "gpio.h"
+#include "client.h"
+#include "command.h"
+#include "multicast.h"
+#include "proto.h"
+#include "pwm.h"
+#include "telemetry.h"
+#include "tone.h"
+#include "worker.h"
+
 // 서보모터 PWM 번호
 #define SERVO_PWM 0
 
@@ -23,324 +34,105 @@
 #define LIGHT_SENSOR_PIN 17
 #define LED2_PIN 27
 
-// GPIO 설정 값
-#define IN 0
-#define OUT 1
-#define LOW 0
-#define HIGH 1
-#define VALUE_MAX 256
-#define DIRECTION_MAX 256
-
 // 소켓 통신 설정
+#define SERVER_IP "192.168.91.9"
 #define PORT 2586
 #define MAXLINE 1024
 
-// 소켓 파일 디스크립터
-int sockfd;
+// 서버 연결 (다시 연결해도 같은 구조체 사용)
+ProtoConn server_conn; // 서버 연결 (메시지 수신 버퍼, 송신 잠금)
+CommandTable commands; // 받은 명령 처리 함수
 struct sockaddr_in servaddr, cliaddr;
 
-// 온도, 습도 저장할 전역변수
-float temp;
-float humid;
-
-// GPIO 핀을 시스템에 내보내기
-static int GPIOExport(int pin) {
-    char buffer[3]; // 핀 번호를 저장할 버퍼
-    ssize_t bytes_written; // 쓰여진 바이트 수
-    int fd; // 파일 디스크립터
-
-    // GPIO export 파일 열기
-    fd = open("/sys/class/gpio/export", O_WRONLY);
-    if (fd == -1) {
-        // 파일 열기 실패 시 오류 메시지 출력
-        fprintf(stderr, "Failed to open export for writing!\n");
-        return -1;
-    }
+// 서보모터 PWM 채널 (마지막으로 쓴 값 기억)
+PWMChannel servo;
 
-    // 핀 번호를 버퍼에 쓰기
-    bytes_written = snprintf(buffer, 3, "%d", pin);
-    write(fd, buffer, bytes_written); // 핀 번호를 export 파일에 쓰기
-    close(fd); // 파일 디스크립터 닫기
-    return 0; // 성공적으로 내보내기 완료
-}
+// 작업 스레드 명령
+enum {
+    CMD_WATER,       // 물 공급 (arg: 온도, 습도)
+    CMD_LIGHT_START, // 일조량 관리 시작
+    CMD_LIGHT_END    // 일조량 관리 종료
+};
 
-// GPIO 핀을 시스템에서 제거
-static int GPIOUnexport(int pin) {
-    char buffer[3]; // 핀 번호를 저장할 버퍼
-    ssize_t bytes_written; // 쓰여진 바이트 수
-    int fd; // 파일 디스크립터
-
-    // GPIO unexport 파일 열기
-    fd = open("/sys/class/gpio/unexport", O_WRONLY);
-    if (fd == -1) {
-        // 파일 열기 실패 시 오류 메시지 출력
-        fprintf(stderr, "Failed to open unexport for writing!\n");
-        return -1;
-    }
-
-    // 핀 번호를 버퍼에 쓰기
-    bytes_written = snprintf(buffer, 3, "%d", pin);
-    write(fd, buffer, bytes_written); // 핀 번호를 unexport 파일에 쓰기
-    close(fd); // 파일 디스크립터 닫기
-    return 0; // 성공적으로 제거 완료
-}
+// 물 부족 알림음 : 도레미레도도도 (Hz), 음 사이에 짧은 쉼표
+static const ToneNote low_water_alarm[] = {
+    {262, 300}, {0, 100}, {294, 300}, {0, 100}, {330, 300}, {0, 100}, {294, 300}, {0, 100},
+    {262, 300}, {0, 100}, {262, 300}, {0, 100}, {262, 300}
+};
 
-// GPIO 핀 방향 설정 (0 = 입력, 1 = 출력)
-static int GPIODirection(int pin, int dir) {
-    static const char s_directions_str[] = "in\0out"; // 방향 문자열
-    char path[DIRECTION_MAX]; // 경로 버퍼
-    int fd; // 파일 디스크립터
-
-    // GPIO 방향 파일 경로 설정
-    snprintf(path, DIRECTION_MAX, "/sys/class/gpio/gpio%d/direction", pin);
-    fd = open(path, O_WRONLY); // 방향 파일 열기
-    if (fd == -1) {
-        // 파일 열기 실패 시 오류 메시지 출력
-        fprintf(stderr, "Failed to open gpio direction for writing!\n");
-        return -1;
-    }
+// 액추에이터 작업 스레드 (시작할 때 한 번 만들어서 계속 사용)
+Worker water_worker;
+Worker light_worker;
 
-    // 방향 설정 (입력 또는 출력)
-    if (write(fd, &s_directions_str[IN == dir ? 0 : 3], IN == dir ? 2 : 3) == -1) {
-        fprintf(stderr, "Failed to set direction!\n");
-        return -1;
-    }
-
-    close(fd); // 파일 디스크립터 닫기
-    return 0; // 성공적으로 방향 설정 완료
-}
-
-// GPIO 핀 값 읽기
-static int GPIORead(int pin) {
-    char path[VALUE_MAX]; // 경로 버퍼
-    char value_str[3]; // 값 문자열 버퍼
-    int fd; // 파일 디스크립터
-
-    // GPIO 값 파일 경로 설정
-    snprintf(path, VALUE_MAX, "/sys/class/gpio/gpio%d/value", pin);
-    fd = open(path, O_RDONLY); // 값 파일 열기
-    if (fd == -1) {
-        // 파일 열기 실패 시 오류 메시지 출력
-        fprintf(stderr, "Failed to open gpio value for reading!\n");
-        return -1;
-    }
-
-    // 값 읽기
-    if (read(fd, value_str, 3) == -1) {
-        // 값 읽기 실패 시 오류 메시지 출력
-        fprintf(stderr, "Failed to read value!\n");
+/***************************************************************************
+ * setup_actuators()
+ * 액추에이터 초기화 함수
+ * 사용할 GPIO 핀과 PWM 채널을 시작할 때 한 번만 내보내고 방향 설정
+ ***************************************************************************/
+int setup_actuators() {
+    // GPIO 핀 내보내기
+    if (GPIOExport(WATER_SUPPLY_PIN) == -1 || GPIOExport(WATER_LEVEL_PIN) == -1 ||
+        GPIOExport(LED_PIN) == -1 || GPIOExport(BUZZER_PIN) == -1 ||
+        GPIOExport(LIGHT_SENSOR_PIN) == -1 || GPIOExport(LED2_PIN) == -1) {
         return -1;
     }
 
-    close(fd); // 파일 디스크립터 닫기
-    return atoi(value_str); // 값을 정수로 변환하여 반환
-}
+    usleep(1000 * 200); // 설정 후 잠시 대기
 
-// GPIO 핀 값 쓰기
-static int GPIOWrite(int pin, int value) {
-    static const char s_values_str[] = "01"; // 값 문자열
-    char path[VALUE_MAX]; // 경로 버퍼
-    int fd; // 파일 디스크립터
-
-    // GPIO 값 파일 경로 설정
-    snprintf(path, VALUE_MAX, "/sys/class/gpio/gpio%d/value", pin);
-    fd = open(path, O_WRONLY); // 값 파일 열기
-    if (fd == -1) {
-        // 파일 열기 실패 시 오류 메시지 출력
-        fprintf(stderr, "Failed to open gpio value for writing!\n");
+    // GPIO 핀 방향 설정
+    if (GPIODirection(WATER_SUPPLY_PIN, IN) == -1 || GPIODirection(WATER_LEVEL_PIN, IN) == -1 ||
+        GPIODirection(LED_PIN, OUT) == -1 || GPIODirection(BUZZER_PIN, OUT) == -1 ||
+        GPIODirection(LIGHT_SENSOR_PIN, IN) == -1 || GPIODirection(LED2_PIN, OUT) == -1) {
         return -1;
     }
 
-    // 값 쓰기
-    if (write(fd, &s_values_str[LOW == value ? 0 : 1], 1) != 1) {
-        // 값 쓰기 실패 시 오류 메시지 출력
-        fprintf(stderr, "Failed to write value!\n");
+    // PWM 채널 내보내기 (채널이 준비될 때까지 기다림)
+    if (PWMChannelOpen(&servo, SERVO_PWM) == -1) {
         return -1;
     }
 
-    close(fd); // 파일 디스크립터 닫기
-    return 0; // 성공적으로 값 쓰기 완료
-}
-
-// PWM 채널 시스템에 내보내기
-static int PWMExport(int pwmnum) {
-    char buffer[3]; // PWM 번호 버퍼
-    int fd, byte; // 파일 디스크립터와 바이트 수
-
-    // PWM export 파일 열기
-    fd = open("/sys/class/pwm/pwmchip0/export", O_WRONLY);
-    if (fd == -1) {
-        // 파일 열기 실패 시 오류 메시지 출력
-        fprintf(stderr, "Failed to open export for export!\n");
+    // 부저 음 재생 스레드 시작 (부저 핀에는 하드웨어 PWM이 없어 타이머로 토글)
+    if (tone_open(BUZZER_PIN) == -1) {
         return -1;
     }
-
-    // PWM 번호 버퍼에 쓰기
-    byte = snprintf(buffer, 3, "%d", pwmnum);
-    write(fd, buffer, byte); // PWM 번호를 export 파일에 쓰기
-    close(fd); // 파일 디스크립터 닫기
-
-    sleep(1); // 설정 후 잠시 대기
-
-    return 0; // 성공적으로 내보내기 완료
-}
-
-// PWM 채널 시스템에서 제거
-static int PWMUnexport(int pwmnum) {
-    char buffer[3];
-    ssize_t bytes_written;
-    int fd;
-    fd = open("/sys/class/pwm/pwmchip0/unexport", O_WRONLY);
-    if (fd == -1) {
-        fprintf(stderr, "Failed to open in unexport!\n");
-        return -1;
-    }
-    bytes_written = snprintf(buffer, 3, "%d", pwmnum);
-    write(fd, buffer, bytes_written);
-    close(fd);
-    sleep(1);
     return 0;
 }
 
-// PWM 활성화 함수
-static int PWMEnable(int pwmnum) {
-    static const char s_enable_str[] = "1"; // 활성화 문자열
-
-    char path[DIRECTION_MAX]; // 경로 버퍼
-    int fd; // 파일 디스크립터
-
-    // PWM enable 파일 경로 설정
-    snprintf(path, DIRECTION_MAX, "/sys/class/pwm/pwmchip0/pwm%d/enable", pwmnum);
-    fd = open(path, O_WRONLY); // enable 파일 열기
-    if (fd == -1) {
-        // 파일 열기 실패 시 오류 메시지 출력
-        fprintf(stderr, "Failed to open in enable!\n");
-        return -1;
-    }
-
-    write(fd, s_enable_str, strlen(s_enable_str)); // enable 파일에 쓰기
-    close(fd); // 파일 디스크립터 닫기
-
-    return 0; // 성공적으로 활성화 완료
-}
-
-// PWM 비활성화 함수
-static int PWMDisable(int pwmnum) {
-    static const char s_disable_str[] = "0"; // 비활성화 문자열
-
-    char path[DIRECTION_MAX]; // 경로 버퍼
-    int fd; // 파일 디스크립터
-
-    // PWM disable 파일 경로 설정
-    snprintf(path, DIRECTION_MAX, "/sys/class/pwm/pwmchip0/pwm%d/enable", pwmnum);
-    fd = open(path, O_WRONLY); // disable 파일 열기
-    if (fd == -1) {
-        // 파일 열기 실패 시 오류 메시지 출력
-        fprintf(stderr, "Failed to open in disable!\n");
-        return -1;
-    }
-
-    write(fd, s_disable_str, strlen(s_disable_str)); // disable 파일에 쓰기
-    close(fd); // 파일 디스크립터 닫기
-
-    return 0; // 성공적으로 비활성화 완료
-}
-
-// PWM 주기 설정 함수
-static int PWMWritePeriod(int pwmnum, int value) {
-    char s_value_str[VALUE_MAX]; // 값 문자열 버퍼
-    char path[VALUE_MAX]; // 경로 버퍼
-    int fd, byte; // 파일 디스크립터와 바이트 수
-
-    // PWM period 파일 경로 설정
-    snprintf(path, VALUE_MAX, "/sys/class/pwm/pwmchip0/pwm%d/period", pwmnum);
-    fd = open(path, O_WRONLY); // period 파일 열기
-    if (fd == -1) {
-        // 파일 열기 실패 시 오류 메시지 출력
-        fprintf(stderr, "Failed to open in period!\n");
-        return -1;
-    }
-    // 값 문자열 버퍼에 쓰기
-    byte = snprintf(s_value_str, VALUE_MAX, "%d", value);
-
-    // period 파일에 쓰기
-    if (write(fd, s_value_str, byte) == -1) {
-        // 값 쓰기 실패 시 오류 메시지 출력
-        fprintf(stderr, "Failed to write value in period!\n");
-        close(fd);
-        return -1;
-    }
-    close(fd); // 파일 디스크립터 닫기
-
-    return 0; // 성공적으로 주기 설정 완료
-}
-
-// PWM 듀티 사이클 설정 함수
-static int PWMWriteDutyCycle(int pwmnum, int value) {
-    char s_value_str[VALUE_MAX]; // 값 문자열 버퍼
-    char path[VALUE_MAX]; // 경로 버퍼
-    int fd, byte; // 파일 디스크립터와 바이트 수
-
-    // PWM duty_cycle 파일 경로 설정
-    snprintf(path, VALUE_MAX, "/sys/class/pwm/pwmchip0/pwm%d/duty_cycle", pwmnum);
-    fd = open(path, O_WRONLY); // duty_cycle 파일 열기
-    if (fd == -1) {
-        // 파일 열기 실패 시 오류 메시지 출력
-        fprintf(stderr, "Failed to open in duty cycle!\n");
-        return -1;
-    }
-    // 값 문자열 버퍼에 쓰기
-    byte = snprintf(s_value_str, VALUE_MAX, "%d", value);
-
-    // duty_cycle 파일에 쓰기
-    if (write(fd, s_value_str, byte) == -1) {
-        // 값 쓰기 실패 시 오류 메시지 출력
-        fprintf(stderr, "Failed to write value in duty cycle!\n");
-        close(fd);
-        return -1;
-    }
-    close(fd); // 파일 디스크립터 닫기
-
-    return 0; // 성공적으로 듀티 사이클 설정 완료
-}
-
 /***************************************************************************
- * dispose_water(void *arg)
- * 쓰레드 cancel시 호출될 함수
- * LED, 부저를 끄고 연결된 GPIO핀, PWM서버를 제거함
+ * dispose_actuators()
+ * 프로그램 종료 시 호출될 함수
+ * LED, 부저를 끄고 연결된 GPIO핀, PWM채널을 제거함
  ***************************************************************************/
-void dispose_water(void *arg) {
-    // 할당한 자원 해제
-    pthread_t *thread_id = (pthread_t*)arg; // 스레드 ID 포인터 가져오기
-
+void dispose_actuators() {
     // LED, 부저 끄기
+    tone_close();
     GPIOWrite(LED_PIN, LOW);
-    GPIOWrite(BUZZER_PIN, LOW);
+    GPIOWrite(LED2_PIN, LOW);
 
     // PWM 핀 unexport
-    PWMUnexport(SERVO_PWM);
-    
+    PWMChannelClose(&servo);
+
     // GPIO 핀 unexport
     GPIOUnexport(WATER_SUPPLY_PIN);
     GPIOUnexport(WATER_LEVEL_PIN);
     GPIOUnexport(LED_PIN);
     GPIOUnexport(BUZZER_PIN);
-
-    free(thread_id); // 스레드 ID 메모리 해제
+    GPIOUnexport(LIGHT_SENSOR_PIN);
+    GPIOUnexport(LED2_PIN);
 }
 
 /***************************************************************************
  * set_servo_angle(int angle)
- * 물 공급 양 계산 함수
- * 온도, 습도와 반비례하게 물 공급 양을 계산함
+ * 서보모터 각도 설정 함수
+ * 각도에 맞는 펄스 폭으로 PWM 듀티 사이클을 설정함
  ***************************************************************************/
 void set_servo_angle(int angle) {
     int pulse_width = (angle * 1000000 / 180) + 1000000; // 1ms ~ 2ms 펄스 폭
     int period = 20000000; // 20ms 주기
 
-    PWMWritePeriod(SERVO_PWM, period); // PWM 주기 설정
-    PWMWriteDutyCycle(SERVO_PWM, pulse_width); // PWM 듀티 사이클 설정
-    PWMEnable(SERVO_PWM); // PWM 활성화
+    // 바뀐 값만 씀 (주기와 활성화는 처음 한 번, 이후에는 듀티 사이클만)
+    PWMChannelSet(&servo, period, pulse_width); // PWM 주기, 듀티 사이클 설정
+    PWMChannelEnable(&servo, 1); // PWM 활성화
 }
 
 /***************************************************************************
@@ -356,289 +148,152 @@ float cal_water_volume(float temp, float humid) {
 }
 
 /***************************************************************************
- * water_control_thread(void* arg)
- * 물 공급 관리 스레드 함수
- * 실시간 온도, 습도에 맞게 서보모터가 동작할 시간을 계산
- * 물 부족이 인식된 상태라면 부저, LED 작동함
- * 물이 충분하거나 공급되면 LED 끄기
+ * water_worker_main(Worker *w, void *arg)
+ * 물 공급 관리 작업 스레드 함수
+ * 물 공급 명령을 받으면 실시간 온도, 습도에 맞게 서보모터가 동작할 시간을 계산
+ * 이후 물 부족이 인식된 상태라면 부저, LED 작동함
+ * 물이 충분하거나 공급되면 LED 끄고 다음 명령을 기다림
+ * 물을 주는 도중 새 물 공급 명령이 오면 새 온도, 습도로 다시 시작함
  ***************************************************************************/
-void* water_control_thread(void* arg) {
-    pthread_setcancelstate(PTHREAD_CANCEL_ENABLE, NULL); // 쓰레드 취소 가능 상태 설정
-    pthread_cleanup_push(dispose_water, arg);
-
-    float volume = cal_water_volume(temp, humid); // 온도와 습도에 따른 물의 양 계산
-    int steps = (int)volume; // 계산된 물의 양을 기반으로 스텝 수 설정
-
-    // 계산된 물의 양만큼 서보모터를 작동시킴
-    for (int i = 0; i < steps; i++) {
-        set_servo_angle(90); // 서보 모터를 90도 위치로 이동
-        usleep(200000); // 0.2초 대기
-        set_servo_angle(0); // 서보 모터를 0도 위치로 이동
-        usleep(200000); // 0.2초 대기
-    }
-
-    // PWM 비활성화
-    PWMDisable(SERVO_PWM);
-
+void water_worker_main(Worker *w, void *arg) {
+    WorkerCmd cmd;
+    int monitoring = 0; // 물 공급 후 수위 감시 중
     int status = 0;
+
     while (1) {
+        // 감시 중이면 1초마다 수위 확인, 아니면 명령이 올 때까지 대기
+        int got = worker_wait(w, &cmd, monitoring ? 1000 : -1);
+
+        while (got == 1 && cmd.type == CMD_WATER) {
+            float volume = cal_water_volume(cmd.arg[0], cmd.arg[1]); // 온도와 습도에 따른 물의 양 계산
+            int steps = (int)volume; // 계산된 물의 양을 기반으로 스텝 수 설정
+
+            got = 0;
+            // 계산된 물의 양만큼 서보모터를 작동시킴
+            for (int i = 0; i < steps && !got; i++) {
+                set_servo_angle(90); // 서보 모터를 90도 위치로 이동
+                got = worker_wait(w, &cmd, 200); // 0.2초 대기 (새 명령이 오면 중단)
+                set_servo_angle(0); // 서보 모터를 0도 위치로 이동
+                if (!got) {
+                    got = worker_wait(w, &cmd, 200); // 0.2초 대기
+                }
+            }
+
+            // PWM 비활성화
+            PWMChannelEnable(&servo, 0);
+            monitoring = 1;
+            status = 0;
+        }
+        if (!monitoring) {
+            continue;
+        }
+
         if (GPIORead(WATER_LEVEL_PIN) == 0){
             if(status == 0){
-                send(sockfd, "WATER LOW", strlen("WATER LOW"), 0); // 서버에 LED 켜짐 전송
+                proto_send_op(&server_conn, PROTO_WATER_LOW); // 서버에 LED 켜짐 전송
                 status = 1;
                 // 물이 부족한 경우 LED와 부저 켜기
                 // status flag로 처음 한번만 액추에이터 동작
                 GPIOWrite(LED_PIN, HIGH);
-
-                // 부저는 다음과 같이 작동하도록 함
-                int melody[] = {262, 294, 330, 294, 262, 262, 262}; // 미레도레미미미 음계
-                for (int i = 0; i < 7; i++) {
-                    GPIOWrite(BUZZER_PIN, HIGH);
-                    usleep(melody[i] * 1000);
-                    GPIOWrite(BUZZER_PIN, LOW);
-                    usleep(100000); // 음과 음 사이의 짧은 시간 대기
-                }
+                tone_play(low_water_alarm, sizeof(low_water_alarm) / sizeof(low_water_alarm[0])); // 백그라운드에서 재생
             }
         } else {
-            send(sockfd, "WATER OK", strlen("WATER OK"), 0);
-            // 물이 충분한 경우 LED와 부저 끄기
+            proto_send_op(&server_conn, PROTO_WATER_OK);
+            // 물이 충분한 경우 LED와 부저 끄기 (재생 중인 알림음도 중단)
             GPIOWrite(LED_PIN, LOW);
-            GPIOWrite(BUZZER_PIN, LOW);
-            break;
+            tone_stop();
+            monitoring = 0;
         }
-        sleep(1);
-    }
-
-    pthread_cleanup_pop(1); // 쓰레드 종료 시 정리 함수 호출
-    return NULL; // 스레드 종료
-}
-
-/***************************************************************************
- * init_water_control()
- * 물공급 관리 초기화 함수
- * 물공급 관리 스레드를 생성함
- ***************************************************************************/
-pthread_t* init_water_control() {
-    printf("Water management start\n"); // 초기화 메시지 출력
-    pthread_t *thread_id = (pthread_t*)malloc(sizeof(pthread_t)); // 스레드 ID 메모리 할당
-    if (thread_id == NULL) {
-        fprintf(stderr, "Failed to allocate memory for thread ID\n");
-        return NULL;
-    }
-
-    // GPIO 핀 내보내기
-    if (GPIOExport(WATER_SUPPLY_PIN) == -1 || GPIOExport(WATER_LEVEL_PIN) == -1 ||
-        GPIOExport(LED_PIN) == -1 || GPIOExport(BUZZER_PIN) == -1) {
-        free(thread_id); // 실패 시 메모리 해제
-        return NULL;
-    }
-
-    usleep(1000 * 200); // 설정 후 잠시 대기
-
-    // GPIO 핀 방향 설정
-    if (GPIODirection(WATER_SUPPLY_PIN, IN) == -1 || GPIODirection(WATER_LEVEL_PIN, IN) == -1 ||
-        GPIODirection(LED_PIN, OUT) == -1 || GPIODirection(BUZZER_PIN, OUT) == -1) {
-        free(thread_id); // 실패 시 메모리 해제
-        return NULL;
-    }
-
-    // PWM 채널 내보내기
-    if (PWMExport(SERVO_PWM) == -1) {
-        free(thread_id); // 실패 시 메모리 해제
-        return NULL;
-    }
-
-    usleep(1000 * 200); // PWM 설정 후 잠시 대기
-
-    // 물 공급 관리 스레드 생성
-    if (pthread_create(thread_id, NULL, water_control_thread, (void*)thread_id) != 0) {
-        free(thread_id); // 실패 시 메모리 해제
-        return NULL;
     }
-
-    return thread_id; // 성공적으로 초기화 완료
 }
 
 /***************************************************************************
- * dispose_light(void *arg)
- * 쓰레드 cancel시 호출될 함수
- * LED를 끄고 연결된 GPIO핀을 제거함
+ * light_worker_main(Worker *w, void *arg)
+ * 일조량 관리 작업 스레드 함수
+ * 시작 명령 이후 조도 센서 값을 읽어와 LED를 작동함, LED 상태 변화 시 서버에 상태 전송
+ * 종료 명령을 받으면 LED를 끄고 다음 시작 명령을 기다림
  ***************************************************************************/
-void dispose_light(void *arg) {
-    // 할당한 자원 해제
-    pthread_t *thread_id = (pthread_t*)arg; // 스레드 ID 포인터 가져오기
+void light_worker_main(Worker *w, void *arg) {
+    WorkerCmd cmd;
+    int running = 0;
+    int previous_status = 0;
 
-    // LED 끄기
-    GPIOWrite(LED2_PIN, LOW);
-    
-    // GPIO 핀 unexport
-    GPIOUnexport(LIGHT_SENSOR_PIN);
-    GPIOUnexport(LED2_PIN);
-
-    free(thread_id); // 스레드 ID 메모리 해제
-}
-
-/***************************************************************************
- * light_control_thread(void* arg)
- * 일조량 관리 스레드 함수
- * 조도 센서 값을 읽어와 LED를 작동함, LED 상태 변화 시 서버에 상태 전송
- ***************************************************************************/
-void* light_control_thread(void* arg) {
-    pthread_setcancelstate(PTHREAD_CANCEL_ENABLE, NULL); // 쓰레드 취소 가능 상태 설정
-    pthread_cleanup_push(dispose_light, arg);
-
-    int previous_status = !(GPIORead(LIGHT_SENSOR_PIN)); // 초기 상태 현재 센서 값과 반대로 설정
-    
     while (1) {
+        // 0.2초마다 체크, 관리 중이 아니면 명령이 올 때까지 대기
+        if (worker_wait(w, &cmd, running ? 200 : -1) == 1) {
+            if (cmd.type == CMD_LIGHT_START && !running) {
+                printf("Light management start\n");
+                running = 1;
+                previous_status = !(GPIORead(LIGHT_SENSOR_PIN)); // 초기 상태 현재 센서 값과 반대로 설정
+            } else if (cmd.type == CMD_LIGHT_END && running) {
+                printf("Light management end\n");
+                running = 0;
+                GPIOWrite(LED2_PIN, LOW); // LED 끄기
+            }
+        }
+        if (!running) {
+            continue;
+        }
+
         int light_value = GPIORead(LIGHT_SENSOR_PIN); // 일조량 센서 값 읽기
         if(previous_status != light_value) {
             if(light_value == 0) {
                 GPIOWrite(LED2_PIN, HIGH); // LED 켜기
-                send(sockfd, "LED ON", strlen("LED ON"), 0); // 서버에 LED 켜짐 전송
+                proto_send_op(&server_conn, PROTO_LED_ON); // 서버에 LED 켜짐 전송
             } else {
                 GPIOWrite(LED2_PIN, LOW); // LED 끄기
-                send(sockfd, "LED OFF", strlen("LED OFF"), 0); // 서버에 LED 꺼짐 전송
+                proto_send_op(&server_conn, PROTO_LED_OFF); // 서버에 LED 꺼짐 전송
             }
         }
         previous_status = light_value;
-        sleep(0.2); // 0.2초마다 체크
     }
-    pthread_cleanup_pop(1); // 쓰레드 종료 시 정리 함수 호출
-    return NULL; // 스레드 종료
 }
 
 /***************************************************************************
- * init_light_control()
- * 일조량 관리 초기화 함수
- * 일조량 관리 스레드를 생성함
+ * 서버에서 오는 명령 처리 함수
+ * 해당 작업 스레드에 명령 전달
+ * 온도, 습도는 서버에 묻지 않고 구독으로 받아둔 최신 값 사용
  ***************************************************************************/
-pthread_t* init_light_control() {
-    printf("Light management start\n");
-    pthread_t *thread_id = (pthread_t*)malloc(sizeof(pthread_t)); // 스레드 ID 메모리 할당
-    if (thread_id == NULL) {
-        fprintf(stderr, "Failed to allocate memory for thread ID\n");
-        return NULL;
-    }
+void on_water(ProtoConn *conn, const ProtoMsg *msg, void *arg) {
+    Telemetry env;
 
-    // GPIO 핀 내보내기
-    if (GPIOExport(LIGHT_SENSOR_PIN) == -1 || GPIOExport(LED2_PIN) == -1) {
-        free(thread_id); // 실패 시 메모리 해제
-        return NULL;
+    if (telemetry_latest(&env) == -1) {
+        printf("No temperature/humidity yet, skip watering\n");
+        return;
     }
+    printf("Water management start\n");
+    worker_post(&water_worker, CMD_WATER, env.temp / 10, env.humid / 10);
+}
 
-    usleep(1000 * 200); // 설정 후 잠시 대기
+void on_snapshot(ProtoConn *conn, const ProtoMsg *msg, void *arg) {
+    Telemetry snapshot;
+    int changed;
 
-    // GPIO 핀 방향 설정
-    if (GPIODirection(LIGHT_SENSOR_PIN, IN) == -1 || GPIODirection(LED2_PIN, OUT) == -1) {
-        free(thread_id); // 실패 시 메모리 해제
-        return NULL;
+    if (telemetry_parse_snapshot(msg, &snapshot, &changed) == 0) {
+        telemetry_store(&snapshot);
     }
-
-    // 일조량 관리 스레드 생성
-    if (pthread_create(thread_id, NULL, light_control_thread, (void*)thread_id) != 0) {
-        free(thread_id); // 실패 시 메모리 해제
-        return NULL;
-    }
-
-    return thread_id; // 성공적으로 초기화 완료
 }
 
-/***************************************************************************
- * request_and_receive(const char* request, char* response)
- * 서버에 요청하고자 하는 정보 요청하고 응답 받는 함수
- * 응답 받는 명령어를 포인터로 반환함
- ***************************************************************************/
-void request_and_receive(const char* request, char* response) {
-    char buffer[MAXLINE]; // 요청을 저장할 버퍼
-    int n;
-
-    // 서버로 요청 전송
-    snprintf(buffer, sizeof(buffer), "%s", request); // 요청을 버퍼에 저장
-    send(sockfd, buffer, strlen(buffer), 0); // 서버로 요청 전송
-
-    // 서버로부터 응답 수신
-    n = recv(sockfd, response, MAXLINE, 0); // 서버로부터 응답 받기
-    if (n < 0) { // 응답 수신 실패 시
-        perror("Receive failed"); // 오류 처리
-        exit(1); // 프로그램 종료
-    }
-    response[n] = '\0'; // 응답 문자열 종료 처리
+void on_light_start(ProtoConn *conn, const ProtoMsg *msg, void *arg) {
+    worker_post(&light_worker, CMD_LIGHT_START, 0, 0);
 }
 
+void on_light_end(ProtoConn *conn, const ProtoMsg *msg, void *arg) {
+    worker_post(&light_worker, CMD_LIGHT_END, 0, 0);
+}
 
-/***************************************************************************
- * socket_communication()
- * 서버와 소켓 통신을 통해 명령을 수신하고 처리하는 함수
- * 명령 수신에 따라 각각의 기능 작동
- ***************************************************************************/
-void socket_communication() {
-    char buffer[MAXLINE]; // 수신 버퍼
-    int n; // 수신 바이트 수
-    pthread_t *water_thread = NULL, *light_thread = NULL; // 스레드 포인터 선언
-
-    // 무한 루프를 통해 계속해서 명령을 수신하고 처리
-    while (1) {
-        n = recv(sockfd, buffer, MAXLINE - 1, 0); // 소켓으로부터 데이터 수신
-        if (n < 0) {
-            perror("recv failed");
-            break;
-        }
-        buffer[n] = '\0'; // 문자열 종료
-
-        // 수신된 메시지에 따라 모드 설정 및 기능 실행
-        if (strcmp(buffer, "WATER") == 0) {
-            // 이전 스레드가 존재하면 종료하고 해제
-            if (water_thread) {
-                pthread_cancel(*water_thread); // 스레드 종료
-                pthread_join(*water_thread, NULL);
-                water_thread = NULL;
-            }
-
-            char response[MAXLINE];
-
-            // 실시간 온도 받아옴
-            request_and_receive("TEMP", response);
-            temp = atoi(response) / 10;
-
-            // 실시간 습도 받아옴
-            request_and_receive("HUMID", response);
-            humid = atoi(response) / 10;
-
-            if (!water_thread) {
-                water_thread = init_water_control();
-                if (water_thread == NULL) {
-                    printf("Failed to initialize water control\n"); // 실패 메시지 출력
-                }
-            }
-        } else if (strcmp(buffer, "LIGHT_START") == 0) {
-            if (!light_thread) {
-                light_thread = init_light_control();
-                if (light_thread == NULL) {
-                    printf("Failed to initialize light control\n"); // 실패 메시지 출력
-                }
-            }
-        } else if (strcmp(buffer, "LIGHT_END") == 0) {
-            if (light_thread) {
-                printf("Light management end\n");
-                pthread_cancel(*light_thread); // 스레드 종료
-                pthread_join(*light_thread, NULL);
-                // free(light_thread);
-                light_thread = NULL;
-            }
-        } else {
-            fprintf(stderr, "Invalid command: %s\n", buffer);
-        }
-    }
+// 액추에이터 노드가 받는 명령 등록
+void setup_commands() {
+    command_init(&commands, ROLE_ACTUATOR);
+    command_register(&commands, PROTO_WATER, on_water, NULL);
+    command_register(&commands, PROTO_LIGHT_START, on_light_start, NULL);
+    command_register(&commands, PROTO_LIGHT_END, on_light_end, NULL);
+    command_register(&commands, PROTO_SNAPSHOT, on_snapshot, NULL);
+}
 
-    // 스레드 종료 대기 및 메모리 해제
-    if (water_thread) {
-        pthread_join(*water_thread, NULL);
-        free(water_thread);
-    }
-    if (light_thread) {
-        pthread_join(*light_thread, NULL);
-        free(light_thread);
-    }
+// Ctrl+C, kill 시 연결을 끊고 정리 후 종료
+void on_signal(int sig) {
+    client_stop();
 }
 
 /***************************************************************************
@@ -649,9 +304,17 @@ int main(int argc, char *argv[]) {
     struct sockaddr_in serv_addr;
     char buffer[1024] = {0};
 
-    // 소켓 파일 디스크립터 생성
-    if ((sockfd = socket(AF_INET, SOCK_STREAM, 0)) < 0) {
-        printf("\n Socket creation error \n");
+    // 연결 전 상태로 초기화 (client_run이 연결할 때마다 소켓을 바꿈, 작업 스레드는 계속 같은 구조체로 보냄)
+    proto_conn_init(&server_conn, -1);
+
+    // 액추에이터 하드웨어는 시작할 때 한 번만 설정하고 작업 스레드 생성
+    if (setup_actuators() == -1) {
+        printf("Failed to initialize actuators\n");
+        return -1;
+    }
+    if (worker_start(&water_worker, "water", water_worker_main, NULL) == -1 ||
+        worker_start(&light_worker, "light", light_worker_main, NULL) == -1) {
+        dispose_actuators();
         return -1;
     }
 
@@ -659,23 +322,27 @@ int main(int argc, char *argv[]) {
     serv_addr.sin_family = AF_INET;
     serv_addr.sin_port = htons(PORT);
 
-    // 서버 주소 변환
-    if (inet_pton(AF_INET, "192.168.91.9", &serv_addr.sin_addr) <= 0) {
-        printf("\nInvalid address/ Address not supported \n");
-        return -1;
+    // 서버 주소 변환 (개발 PC에서는 HOMEFARM_SERVER 로 변경 가능)
+    const char *server_ip = getenv("HOMEFARM_SERVER");
+    if (server_ip == NULL) {
+        server_ip = SERVER_IP;
     }
-
-    // 서버에 연결 요청
-    if (connect(sockfd, (struct sockaddr *)&serv_addr, sizeof(serv_addr)) < 0) {
-        printf("\nConnection Failed \n");
+    if (inet_pton(AF_INET, server_ip, &serv_addr.sin_addr) <= 0) {
+        printf("\nInvalid address/ Address not supported \n");
+        dispose_actuators();
         return -1;
     }
-    printf("Socket Connection Complete!\n");
+    setup_commands();
+    signal(SIGINT, on_signal);
+    signal(SIGTERM, on_signal);
 
-    // 소켓 통신을 통해 명령 수신 및 처리
-    socket_communication();
+    // 서버와 연결하고 끊어지면 다시 연결 (종료 시그널을 받을 때까지)
+    // 연결이 끊긴 동안 작업 스레드가 보내는 상태 알림은 ENOTCONN으로 실패함
+    mcast_start(&server_conn, TOPIC_ENV);
+    client_run(&server_conn, &serv_addr, ROLE_ACTUATOR, TOPIC_ENV, &commands, NULL, NULL);
+    mcast_stop();
 
-    close(sockfd);
+    dispose_actuators();
 
     return 0;
 }
\ No newline at end of file
@@ -0,0 +1,233 @@
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <spawn.h>
+#include <time.h>
+#include <sys/wait.h>
+
+#include "sensor.h"
+
+// 재시작 백오프 (ms)
+#define BACKOFF_MIN_MS 500
+#define BACKOFF_MAX_MS 30000
+
+#define HELPER_ARGV_MAX 8
+#define HELPER_LINE_MAX 128
+
+extern char **environ;
+
+// 두 시각의 차이를 ms 단위로 반환
+static long elapsed_ms(const struct timespec *from, const struct timespec *to) {
+    return (to->tv_sec - from->tv_sec) * 1000 + (to->tv_nsec - from->tv_nsec) / 1000000;
+}
+
+// 실패한 플러그인을 멈추고 다음 재시작 시각 계산
+static void schedule_restart(SensorPlugin *p) {
+    if (p->running) {
+        p->stop(p);
+        p->running = 0;
+    }
+    p->restarts++;
+    p->backoff_ms = p->backoff_ms == 0 ? BACKOFF_MIN_MS : p->backoff_ms * 2;
+    if (p->backoff_ms > BACKOFF_MAX_MS) {
+        p->backoff_ms = BACKOFF_MAX_MS;
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &p->retry_at);
+    p->retry_at.tv_sec += p->backoff_ms / 1000;
+    p->retry_at.tv_nsec += (p->backoff_ms % 1000) * 1000000L;
+    if (p->retry_at.tv_nsec >= 1000000000L) {
+        p->retry_at.tv_sec++;
+        p->retry_at.tv_nsec -= 1000000000L;
+    }
+    fprintf(stderr, "sensor %s failed, restart in %d ms (restarts: %d)\n",
+            p->name, p->backoff_ms, p->restarts);
+}
+
+int sensor_next(SensorPlugin *p, SensorReading *out, int timeout_ms) {
+    struct timespec start, now;
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    while (1) {
+        int wait_ms;
+
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        wait_ms = timeout_ms < 0 ? -1 : timeout_ms - (int)elapsed_ms(&start, &now);
+        if (timeout_ms >= 0 && wait_ms <= 0) {
+            return 0;
+        }
+
+        // 플러그인이 멈춰 있으면 백오프 시간이 지난 뒤 다시 시작
+        if (!p->running) {
+            long until_retry = elapsed_ms(&now, &p->retry_at);
+            if (until_retry > 0) {
+                if (wait_ms >= 0 && wait_ms < until_retry) {
+                    until_retry = wait_ms;
+                }
+                poll(NULL, 0, (int)until_retry);
+                continue;
+            }
+            if (p->start(p) == -1) {
+                schedule_restart(p);
+                continue;
+            }
+            p->running = 1;
+        }
+
+        struct pollfd pfd = { .fd = p->fd(p), .events = POLLIN };
+        if (poll(&pfd, 1, wait_ms) < 0 && errno != EINTR) {
+            perror("sensor poll");
+            return 0;
+        }
+        if (pfd.revents == 0) {
+            continue;
+        }
+
+        int ret = p->read(p, out);
+        if (ret == 1) {
+            p->backoff_ms = 0; // 정상 동작하면 백오프 초기화
+            return 1;
+        }
+        if (ret == -1) {
+            schedule_restart(p);
+        }
+    }
+}
+
+void sensor_stop(SensorPlugin *p) {
+    if (p->running) {
+        p->stop(p);
+        p->running = 0;
+    }
+}
+
+/***************************************************************************
+ * helper 프로세스 플러그인
+ ***************************************************************************/
+typedef struct {
+    char *argv[HELPER_ARGV_MAX + 1];
+    pid_t pid;
+    int fd;                      // helper stdout 파이프 (읽기 쪽)
+    char line[HELPER_LINE_MAX];  // 아직 줄바꿈이 오지 않은 출력
+    int line_len;
+} HelperState;
+
+static int helper_start(SensorPlugin *p) {
+    HelperState *st = p->priv;
+    posix_spawn_file_actions_t actions;
+    int pipefd[2];
+    int ret;
+
+    if (pipe2(pipefd, O_CLOEXEC) == -1) {
+        perror("pipe");
+        return -1;
+    }
+
+    // helper의 stdout을 파이프 쓰기 쪽으로 연결 (dup2 대상은 CLOEXEC 해제됨)
+    posix_spawn_file_actions_init(&actions);
+    posix_spawn_file_actions_adddup2(&actions, pipefd[1], STDOUT_FILENO);
+    ret = posix_spawnp(&st->pid, st->argv[0], &actions, NULL, st->argv, environ);
+    posix_spawn_file_actions_destroy(&actions);
+    close(pipefd[1]);
+    if (ret != 0) {
+        fprintf(stderr, "Failed to spawn %s: %s\n", st->argv[0], strerror(ret));
+        close(pipefd[0]);
+        return -1;
+    }
+
+    fcntl(pipefd[0], F_SETFL, fcntl(pipefd[0], F_GETFL) | O_NONBLOCK);
+    st->fd = pipefd[0];
+    st->line_len = 0;
+    printf("sensor %s : helper started (pid %d)\n", p->name, (int)st->pid);
+    return 0;
+}
+
+static int helper_fd(SensorPlugin *p) {
+    return ((HelperState*)p->priv)->fd;
+}
+
+static int helper_read(SensorPlugin *p, SensorReading *out) {
+    HelperState *st = p->priv;
+    int got = 0;
+
+    while (1) {
+        ssize_t n = read(st->fd, st->line + st->line_len, HELPER_LINE_MAX - 1 - st->line_len);
+        if (n == 0) {
+            return -1; // helper 종료 (파이프 EOF)
+        }
+        if (n < 0) {
+            if (errno == EAGAIN || errno == EINTR) {
+                return got;
+            }
+            return -1;
+        }
+        st->line_len += n;
+        st->line[st->line_len] = '\0';
+
+        // 완성된 줄마다 "temp,humid" 파싱, 가장 마지막 값을 사용
+        char *start = st->line;
+        char *nl;
+        while ((nl = strchr(start, '\n')) != NULL) {
+            float temperature, humidity;
+            *nl = '\0';
+            if (sscanf(start, "%f,%f", &temperature, &humidity) == 2) {
+                out->temp = temperature;
+                out->humid = humidity;
+                got = 1;
+            } else {
+                printf("Failed to sensor data : %s\n", start);
+            }
+            start = nl + 1;
+        }
+        st->line_len -= start - st->line;
+        memmove(st->line, start, st->line_len);
+
+        // 줄바꿈 없이 버퍼가 가득 찬 경우 버림
+        if (st->line_len == HELPER_LINE_MAX - 1) {
+            st->line_len = 0;
+        }
+    }
+}
+
+static void helper_stop(SensorPlugin *p) {
+    HelperState *st = p->priv;
+
+    if (st->fd != -1) {
+        close(st->fd);
+        st->fd = -1;
+    }
+    if (st->pid > 0) {
+        kill(st->pid, SIGTERM);
+        waitpid(st->pid, NULL, 0);
+        st->pid = 0;
+    }
+}
+
+SensorPlugin *sensor_helper_create(const char *name, char *const argv[]) {
+    SensorPlugin *p = calloc(1, sizeof(SensorPlugin));
+    HelperState *st = calloc(1, sizeof(HelperState));
+    if (p == NULL || st == NULL) {
+        free(p);
+        free(st);
+        return NULL;
+    }
+
+    for (int i = 0; i < HELPER_ARGV_MAX && argv[i] != NULL; i++) {
+        st->argv[i] = argv[i];
+    }
+    st->fd = -1;
+
+    p->name = name;
+    p->start = helper_start;
+    p->fd = helper_fd;
+    p->read = helper_read;
+    p->stop = helper_stop;
+    p->priv = st;
+    return p;
+}
@@ -0,0 +1,52 @@
+#ifndef SENSOR_H
+#define SENSOR_H
+
+#include <time.h>
+
+// 온습도 측정값
+typedef struct {
+    float temp;  // 온도 (C)
+    float humid; // 습도 (%)
+} SensorReading;
+
+/***************************************************************************
+ * 센서 플러그인
+ * 측정값을 만들어내는 방법(외부 helper 프로세스, 네이티브 드라이버 등)을
+ * start/fd/read/stop 함수 테이블로 감싸서 같은 방식으로 읽을 수 있게 함
+ * read는 블로킹하지 않아야 함 : 1 = 측정값 있음, 0 = 아직 없음, -1 = 재시작 필요
+ ***************************************************************************/
+typedef struct SensorPlugin SensorPlugin;
+struct SensorPlugin {
+    const char *name;
+    int (*start)(SensorPlugin *p);
+    int (*fd)(SensorPlugin *p);
+    int (*read)(SensorPlugin *p, SensorReading *out);
+    void (*stop)(SensorPlugin *p);
+    void *priv;
+
+    // sensor_next가 관리하는 재시작 상태
+    int running;
+    int restarts;
+    int backoff_ms;
+    struct timespec retry_at;
+};
+
+/***************************************************************************
+ * sensor_next(SensorPlugin *p, SensorReading *out, int timeout_ms)
+ * 플러그인의 fd를 poll()로 기다렸다가 측정값 하나를 읽음 (timeout_ms < 0 이면 무한 대기)
+ * 플러그인이 실패하면 지수 백오프로 기다린 뒤 다시 시작함
+ * 1 = 측정값 있음, 0 = timeout
+ ***************************************************************************/
+int sensor_next(SensorPlugin *p, SensorReading *out, int timeout_ms);
+
+// 플러그인 정지
+void sensor_stop(SensorPlugin *p);
+
+/***************************************************************************
+ * sensor_helper_create(const char *name, char *const argv[])
+ * 외부 helper 프로세스를 한 번만 posix_spawn 하고
+ * stdout으로 계속 출력되는 "temp,humid" 줄을 파이프로 읽는 플러그인 생성
+ ***************************************************************************/
+SensorPlugin *sensor_helper_create(const char *name, char *const argv[]);
+
+#endif
@@ -0,0 +1,181 @@
+#include <string.h>
+#include <pthread.h>
+#include <arpa/inet.h>
+
+#include "telemetry.h"
+
+static pthread_mutex_t s_lock = PTHREAD_MUTEX_INITIALIZER;
+static Telemetry s_latest;
+static int s_valid = 0;
+
+int telemetry_subscribe(ProtoConn *conn, int topics) {
+    unsigned char payload[TELEMETRY_SUBSCRIBE_LEN] = { topics };
+
+    return proto_send(conn, PROTO_SUBSCRIBE, payload, TELEMETRY_SUBSCRIBE_LEN);
+}
+
+int telemetry_parse_subscribe(const ProtoMsg *msg, int *topics) {
+    if (msg->length != TELEMETRY_SUBSCRIBE_LEN) {
+        return -1;
+    }
+    *topics = msg->payload[0] & (TOPIC_ALL | TOPIC_MULTICAST);
+    return 0;
+}
+
+void telemetry_encode_snapshot(const Telemetry *t, int changed, unsigned char *payload) {
+    unsigned short temp16 = htons((short)t->temp);
+    unsigned short humid16 = htons((short)t->humid);
+
+    payload[0] = changed;
+    memcpy(payload + 1, &temp16, 2);
+    memcpy(payload + 3, &humid16, 2);
+    payload[5] = t->led;
+    payload[6] = t->water_low;
+    payload[7] = t->grown;
+}
+
+int telemetry_decode_snapshot(const unsigned char *payload, int length, Telemetry *t, int *changed) {
+    unsigned short temp16, humid16;
+
+    if (length != TELEMETRY_SNAPSHOT_LEN) {
+        return -1;
+    }
+    memcpy(&temp16, payload + 1, 2);
+    memcpy(&humid16, payload + 3, 2);
+    *changed = payload[0];
+    t->temp = (short)ntohs(temp16);
+    t->humid = (short)ntohs(humid16);
+    t->led = payload[5];
+    t->water_low = payload[6];
+    t->grown = payload[7];
+    return 0;
+}
+
+int telemetry_publish(ProtoConn *conn, const Telemetry *t, int changed) {
+    unsigned char payload[TELEMETRY_SNAPSHOT_LEN];
+
+    telemetry_encode_snapshot(t, changed, payload);
+    return proto_send(conn, PROTO_SNAPSHOT, payload, TELEMETRY_SNAPSHOT_LEN);
+}
+
+int telemetry_parse_snapshot(const ProtoMsg *msg, Telemetry *t, int *changed) {
+    return telemetry_decode_snapshot(msg->payload, msg->length, t, changed);
+}
+
+#define PLANT_TEMP_BASE 200   // 20.0도
+#define PLANT_HUMID_BASE 500  // 50.0%
+
+// varint 하나 추가 (다음 위치, 공간이 모자라면 -1)
+static int put_varint(unsigned char *buf, int pos, int size, unsigned int value) {
+    do {
+        if (pos >= size) {
+            return -1;
+        }
+        buf[pos++] = (value & 0x7f) | (value > 0x7f ? 0x80 : 0);
+        value >>= 7;
+    } while (value);
+    return pos;
+}
+
+// varint 하나 읽기 (다음 위치, 잘렸거나 32비트를 넘으면 -1)
+static int get_varint(const unsigned char *buf, int pos, int length, unsigned int *value) {
+    int shift = 0;
+
+    *value = 0;
+    while (pos < length && shift < 32) {
+        unsigned char b = buf[pos++];
+        if (shift == 28 && (b & 0x70)) {
+            return -1;
+        }
+        *value |= (unsigned int)(b & 0x7f) << shift;
+        if (!(b & 0x80)) {
+            return pos;
+        }
+        shift += 7;
+    }
+    return -1;
+}
+
+static unsigned int zigzag(int v) {
+    return ((unsigned int)v << 1) ^ (unsigned int)(v >> 31);
+}
+
+static int unzigzag(unsigned int v) {
+    return (int)(v >> 1) ^ -(int)(v & 1);
+}
+
+int plant_data_encode(const PlantData *d, unsigned char *buf, int size) {
+    int present = d->present & PLANT_ALL;
+    int pos;
+
+    if (size < 1) {
+        return -1;
+    }
+    buf[0] = PLANT_DATA_VERSION;
+    pos = put_varint(buf, 1, size, present);
+    if (pos != -1 && (present & PLANT_TEMP)) {
+        pos = put_varint(buf, pos, size, zigzag((int)((unsigned int)d->temp - PLANT_TEMP_BASE)));
+    }
+    if (pos != -1 && (present & PLANT_HUMID)) {
+        pos = put_varint(buf, pos, size, zigzag((int)((unsigned int)d->humid - PLANT_HUMID_BASE)));
+    }
+    if (pos != -1 && (present & PLANT_LED)) {
+        pos = put_varint(buf, pos, size, d->led);
+    }
+    return pos;
+}
+
+int plant_data_decode(const unsigned char *buf, int length, PlantData *d) {
+    unsigned int present, value;
+    int pos;
+
+    if (length < 1 || buf[0] != PLANT_DATA_VERSION) {
+        return -1;
+    }
+    pos = get_varint(buf, 1, length, &present);
+    if (pos == -1) {
+        return -1;
+    }
+    memset(d, 0, sizeof(PlantData));
+    d->present = present & PLANT_ALL;
+
+    // 비트 순서대로 값이 있음, 모르는 비트의 값은 읽고 버림
+    for (int bit = 0; bit < 32 && (present >> bit); bit++) {
+        if (!(present & (1u << bit))) {
+            continue;
+        }
+        pos = get_varint(buf, pos, length, &value);
+        if (pos == -1) {
+            return -1;
+        }
+        switch (1u << bit) {
+        case PLANT_TEMP:
+            d->temp = (int)((unsigned int)unzigzag(value) + PLANT_TEMP_BASE);
+            break;
+        case PLANT_HUMID:
+            d->humid = (int)((unsigned int)unzigzag(value) + PLANT_HUMID_BASE);
+            break;
+        case PLANT_LED:
+            d->led = value;
+            break;
+        }
+    }
+    return 0;
+}
+
+void telemetry_store(const Telemetry *t) {
+    pthread_mutex_lock(&s_lock);
+    s_latest = *t;
+    s_valid = 1;
+    pthread_mutex_unlock(&s_lock);
+}
+
+int telemetry_latest(Telemetry *t) {
+    int valid;
+
+    pthread_mutex_lock(&s_lock);
+    *t = s_latest;
+    valid = s_valid;
+    pthread_mutex_unlock(&s_lock);
+    return valid ? 0 : -1;
+}
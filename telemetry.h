@@ -0,0 +1,94 @@
+#ifndef TELEMETRY_H
+#define TELEMETRY_H
+
+#include "proto.h"
+
+// 구독할 수 있는 값 묶음 (비트 조합으로 사용)
+typedef enum {
+    TOPIC_ENV = 1,     // 온도, 습도
+    TOPIC_LED = 2,     // 일조량 관리 LED 상태
+    TOPIC_WATER = 4,   // 물 부족 상태
+    TOPIC_GROWTH = 8,  // 식물 성장 완료
+    TOPIC_ALL = 15,
+    TOPIC_MULTICAST = 0x80 // 바뀐 값은 multicast로 받음 (TCP로는 구독할 때 현재 값만, multicast.h)
+} TelemetryTopic;
+
+// 허브가 가진 최신 값 전체 (온도, 습도는 10배 값)
+typedef struct {
+    int temp;
+    int humid;
+    int led;
+    int water_low;
+    int grown;
+} Telemetry;
+
+/***************************************************************************
+ * 구독 / 발행
+ * 노드는 연결 후 한 번 PROTO_SUBSCRIBE로 받을 값 묶음을 알리고
+ * 허브는 구독한 값이 바뀔 때마다 전체 값을 PROTO_SNAPSHOT으로 보냄
+ * (구독 직후에도 현재 값을 한 번 보냄)
+ *
+ * SUBSCRIBE :  | topics (1) |
+ * SNAPSHOT  :  | changed topics (1) | temp (2) | humid (2) | led (1) | water_low (1) | grown (1) |
+ ***************************************************************************/
+#define TELEMETRY_SUBSCRIBE_LEN 1
+#define TELEMETRY_SNAPSHOT_LEN 8
+
+int telemetry_subscribe(ProtoConn *conn, int topics);
+int telemetry_parse_subscribe(const ProtoMsg *msg, int *topics);
+
+int telemetry_publish(ProtoConn *conn, const Telemetry *t, int changed);
+int telemetry_parse_snapshot(const ProtoMsg *msg, Telemetry *t, int *changed);
+
+// SNAPSHOT payload만 만들기/읽기 (multicast datagram에서도 사용)
+void telemetry_encode_snapshot(const Telemetry *t, int changed, unsigned char *payload);
+int telemetry_decode_snapshot(const unsigned char *payload, int length, Telemetry *t, int *changed);
+
+/***************************************************************************
+ * 식물 상태 (PLANT UPDATE 요청에 대한 PROTO_REPLY의 응답 내용, rpc_reply_data)
+ * 구조체를 그대로 보내지 않고 버전, 있는 값 표시(presence), 값 순서로 보냄
+ *
+ *  | version (1) | presence (varint) | 값 (varint) ... |
+ *
+ * varint : 7비트씩 낮은 자리부터, 다음 바이트가 있으면 최상위 비트 1
+ * 온도, 습도 : 기준값(20.0도, 50.0%)과의 차이를 zigzag(0, -1, 1, -2 ...)로 바꿔서 보냄
+ *              보통 범위(±6.3)이면 1바이트, 전체가 5바이트 정도
+ * 새 값은 presence의 다음 비트를 쓰고 항상 varint 하나로 보냄
+ * 이전 보드는 모르는 비트의 값을 읽고 버리므로 그대로 동작함
+ * version은 이 규칙을 지킬 수 없는 변경일 때만 올림
+ ***************************************************************************/
+#define PLANT_DATA_VERSION 1
+#define PLANT_DATA_MAX 32            // 인코딩된 최대 길이
+
+// 있는 값 표시 (비트 조합)
+typedef enum {
+    PLANT_TEMP = 1,
+    PLANT_HUMID = 2,
+    PLANT_LED = 4,
+    PLANT_ALL = 7
+} PlantField;
+
+// 식물 상태 (온도, 습도는 10배 값)
+typedef struct {
+    int present;   // PlantField 조합
+    int temp;
+    int humid;
+    int led;
+} PlantData;
+
+// buf에 인코딩 (길이 반환, 공간이 모자라면 -1)
+int plant_data_encode(const PlantData *d, unsigned char *buf, int size);
+
+// 디코딩 (0 = 성공, -1 = 잘린 메시지, 다른 버전, 범위를 넘는 값)
+int plant_data_decode(const unsigned char *buf, int length, PlantData *d);
+
+/***************************************************************************
+ * 노드 쪽 최신 값
+ * 수신 스레드가 받은 snapshot을 저장해두고 다른 스레드는 네트워크를 거치지 않고 읽음
+ ***************************************************************************/
+void telemetry_store(const Telemetry *t);
+
+// 마지막으로 받은 값 (0 = 성공, -1 = 아직 받은 값 없음)
+int telemetry_latest(Telemetry *t);
+
+#endif
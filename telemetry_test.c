@@ -0,0 +1,159 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+
+#include "telemetry.h"
+
+/***************************************************************************
+ * telemetry_test
+ * PlantData 인코딩(plant_data_encode / plant_data_decode) 확인
+ *  - 모든 presence 조합의 왕복
+ *  - INT_MIN / INT_MAX, 기준값(200, 500) 주변 zigzag 경계
+ *  - 잘린 메시지는 모두 -1
+ *  - 새 보드가 보낸 모르는 presence 비트는 건너뜀
+ *  - 임의 바이트 fuzz (정확한 크기로 할당하므로 -fsanitize=address로 빌드하면 넘어 읽기를 잡음)
+ ***************************************************************************/
+#define FUZZ_ROUNDS 1000000
+#define FUZZ_MAX_LEN 24
+
+static int s_failed = 0;
+
+#define CHECK(cond, ...) do { \
+    if (!(cond)) { \
+        printf("FAIL %s:%d : ", __FILE__, __LINE__); \
+        printf(__VA_ARGS__); \
+        printf("\n"); \
+        s_failed++; \
+    } \
+} while (0)
+
+// 인코딩 -> 디코딩 결과가 같은지, 인코딩 길이 반환
+static int roundtrip(int present, int temp, int humid, int led) {
+    unsigned char buf[PLANT_DATA_MAX];
+    PlantData in = { present, temp, humid, led };
+    PlantData out;
+    int len = plant_data_encode(&in, buf, sizeof(buf));
+
+    CHECK(len > 0, "encode present %d temp %d humid %d", present, temp, humid);
+    if (len <= 0) {
+        return len;
+    }
+    CHECK(plant_data_decode(buf, len, &out) == 0, "decode present %d temp %d humid %d", present, temp, humid);
+    CHECK(out.present == present, "present %d -> %d", present, out.present);
+    if (present & PLANT_TEMP) {
+        CHECK(out.temp == temp, "temp %d -> %d", temp, out.temp);
+    }
+    if (present & PLANT_HUMID) {
+        CHECK(out.humid == humid, "humid %d -> %d", humid, out.humid);
+    }
+    if (present & PLANT_LED) {
+        CHECK(out.led == led, "led %d -> %d", led, out.led);
+    }
+
+    // 모든 잘린 앞부분은 실패해야 함 (정확한 크기로 복사해서 넘어 읽기 확인)
+    for (int k = 0; k < len; k++) {
+        unsigned char *part = malloc(k ? k : 1);
+        memcpy(part, buf, k);
+        CHECK(plant_data_decode(part, k, &out) == -1, "prefix %d/%d of temp %d humid %d accepted", k, len, temp, humid);
+        free(part);
+    }
+    return len;
+}
+
+static void test_roundtrip(void) {
+    static const int values[] = {
+        0, 1, -1, 137, 263, 1000, -400,
+        INT_MAX, INT_MIN, INT_MAX - 200, INT_MIN + 200,
+    };
+    int count = sizeof(values) / sizeof(values[0]);
+
+    for (int present = 0; present <= PLANT_ALL; present++) {
+        for (int i = 0; i < count; i++) {
+            for (int j = 0; j < count; j++) {
+                roundtrip(present, values[i], values[j], (i + j) & 1);
+            }
+        }
+    }
+}
+
+// 기준값과의 차이가 zigzag 1바이트(-64 ~ 63)를 넘는 곳에서 길이가 늘어나는지
+static void test_zigzag_edges(void) {
+    static const struct {
+        int delta;
+        int bytes; // 값 하나의 varint 길이
+    } edges[] = {
+        { 0, 1 }, { -1, 1 }, { 1, 1 }, { 63, 1 }, { -64, 1 },
+        { 64, 2 }, { -65, 2 }, { 8191, 2 }, { -8192, 2 }, { 8192, 3 }, { -8193, 3 },
+    };
+    int count = sizeof(edges) / sizeof(edges[0]);
+
+    for (int i = 0; i < count; i++) {
+        // version(1) + presence(1) + 값
+        int len = roundtrip(PLANT_TEMP, 200 + edges[i].delta, 0, 0);
+        CHECK(len == 2 + edges[i].bytes, "temp delta %d : %d bytes", edges[i].delta, len);
+        len = roundtrip(PLANT_HUMID, 0, 500 + edges[i].delta, 0);
+        CHECK(len == 2 + edges[i].bytes, "humid delta %d : %d bytes", edges[i].delta, len);
+    }
+    CHECK(roundtrip(PLANT_ALL, 240, 500, 1) == 5, "typical message is not 5 bytes");
+}
+
+// 새 보드 : 같은 version에 모르는 비트 3, 5의 값이 섞여 있음
+static void test_unknown_fields(void) {
+    // presence 0x2f = temp, humid, led, bit 3, bit 5
+    static const unsigned char newer[] = {
+        PLANT_DATA_VERSION, 0x2f,
+        0x50,        // temp : zigzag 80 -> +40 -> 240
+        0x00,        // humid : 500
+        0x01,        // led
+        0xac, 0x02,  // bit 3 : 2바이트 varint
+        0x05,        // bit 5
+    };
+    unsigned char other[] = { PLANT_DATA_VERSION + 1, 0x01, 0x00 };
+    PlantData d;
+
+    CHECK(plant_data_decode(newer, sizeof(newer), &d) == 0, "newer message rejected");
+    CHECK(d.present == PLANT_ALL, "present %d", d.present);
+    CHECK(d.temp == 240 && d.humid == 500 && d.led == 1, "temp %d humid %d led %d", d.temp, d.humid, d.led);
+    CHECK(plant_data_decode(newer, sizeof(newer) - 1, &d) == -1, "missing unknown field value accepted");
+    CHECK(plant_data_decode(other, sizeof(other), &d) == -1, "other version accepted");
+}
+
+// 임의 바이트 (첫 바이트는 대부분 올바른 version으로 해서 안쪽까지 들어가게)
+static void test_fuzz(void) {
+    unsigned int seed = 1;
+    long accepted = 0;
+
+    for (int round = 0; round < FUZZ_ROUNDS; round++) {
+        int len = rand_r(&seed) % (FUZZ_MAX_LEN + 1);
+        unsigned char *buf = malloc(len ? len : 1);
+        PlantData d;
+
+        for (int k = 0; k < len; k++) {
+            buf[k] = rand_r(&seed);
+        }
+        if (len > 0 && rand_r(&seed) % 8 != 0) {
+            buf[0] = PLANT_DATA_VERSION;
+        }
+        if (plant_data_decode(buf, len, &d) == 0) {
+            accepted++;
+            CHECK((d.present & ~PLANT_ALL) == 0, "present %d has unknown bits", d.present);
+        }
+        free(buf);
+    }
+    printf("fuzz : %d inputs, %ld decoded\n", FUZZ_ROUNDS, accepted);
+}
+
+int main(void) {
+    test_roundtrip();
+    test_zigzag_edges();
+    test_unknown_fields();
+    test_fuzz();
+
+    if (s_failed) {
+        printf("%d checks FAILED\n", s_failed);
+        return 1;
+    }
+    printf("all checks passed\n");
+    return 0;
+}
@@ -0,0 +1,176 @@
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <pthread.h>
+
+#include "gpio.h"
+#include "tone.h"
+
+typedef struct {
+    ToneNote notes[TONE_NOTES_MAX];
+    int count;
+} ToneSeq;
+
+static int s_pin = -1;
+static pthread_t s_thread;
+static pthread_mutex_t s_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t s_cond;
+static ToneSeq s_queue[TONE_QUEUE];
+static int s_head = 0;
+static int s_count = 0;
+static int s_playing = 0;
+static int s_generation = 0; // tone_stop 마다 증가, 재생 중인 음이 확인하여 중단
+static int s_quit = 0;
+
+// 절대 시각 ts에 ns 더하기
+static void ts_add(struct timespec *ts, long ns) {
+    ts->tv_nsec += ns;
+    while (ts->tv_nsec >= 1000000000L) {
+        ts->tv_sec++;
+        ts->tv_nsec -= 1000000000L;
+    }
+}
+
+// ts가 end보다 앞이면 1
+static int ts_before(const struct timespec *ts, const struct timespec *end) {
+    return ts->tv_sec < end->tv_sec || (ts->tv_sec == end->tv_sec && ts->tv_nsec < end->tv_nsec);
+}
+
+// 음 하나 재생, tone_stop으로 중단되면 0 반환
+static int play_note(const ToneNote *note, int generation) {
+    struct timespec now, end;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    end = now;
+    ts_add(&end, note->duration_ms * 1000000L);
+
+    if (note->freq_hz <= 0) {
+        // 쉼표는 조건 변수로 기다려서 중단 요청에 바로 반응
+        int finished;
+        pthread_mutex_lock(&s_mutex);
+        while (generation == s_generation && !s_quit &&
+               pthread_cond_timedwait(&s_cond, &s_mutex, &end) == 0) {
+        }
+        finished = generation == s_generation && !s_quit;
+        pthread_mutex_unlock(&s_mutex);
+        return finished;
+    }
+
+    // 반주기마다 토글, 다음 시각을 절대 시각으로 계산하여 오차가 쌓이지 않음
+    long half_ns = 500000000L / note->freq_hz;
+    int value = HIGH;
+    while (ts_before(&now, &end)) {
+        if (__atomic_load_n(&s_generation, __ATOMIC_RELAXED) != generation ||
+            __atomic_load_n(&s_quit, __ATOMIC_RELAXED)) {
+            GPIOWrite(s_pin, LOW);
+            return 0;
+        }
+        GPIOWrite(s_pin, value);
+        value = !value;
+        ts_add(&now, half_ns);
+        clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &now, NULL);
+    }
+    GPIOWrite(s_pin, LOW);
+    return 1;
+}
+
+static void *tone_thread(void *arg) {
+    ToneSeq seq;
+
+    while (1) {
+        pthread_mutex_lock(&s_mutex);
+        s_playing = 0;
+        while (s_count == 0 && !s_quit) {
+            pthread_cond_wait(&s_cond, &s_mutex);
+        }
+        if (s_quit) {
+            pthread_mutex_unlock(&s_mutex);
+            break;
+        }
+        seq = s_queue[s_head];
+        s_head = (s_head + 1) % TONE_QUEUE;
+        s_count--;
+        s_playing = 1;
+        int generation = s_generation;
+        pthread_mutex_unlock(&s_mutex);
+
+        for (int i = 0; i < seq.count; i++) {
+            if (!play_note(&seq.notes[i], generation)) {
+                break;
+            }
+        }
+    }
+    return NULL;
+}
+
+int tone_open(int pin) {
+    pthread_condattr_t attr;
+
+    if (GPIODirection(pin, OUT) == -1 || GPIOWrite(pin, LOW) == -1) {
+        return -1;
+    }
+    s_pin = pin;
+    s_quit = 0;
+
+    pthread_condattr_init(&attr);
+    pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+    pthread_cond_init(&s_cond, &attr);
+    pthread_condattr_destroy(&attr);
+
+    if (pthread_create(&s_thread, NULL, tone_thread, NULL) != 0) {
+        fprintf(stderr, "Failed to start tone thread\n");
+        s_pin = -1;
+        return -1;
+    }
+    return 0;
+}
+
+int tone_play(const ToneNote *notes, int count) {
+    if (count > TONE_NOTES_MAX) {
+        count = TONE_NOTES_MAX;
+    }
+
+    pthread_mutex_lock(&s_mutex);
+    if (s_pin == -1 || s_count == TONE_QUEUE) {
+        pthread_mutex_unlock(&s_mutex);
+        return -1;
+    }
+    ToneSeq *seq = &s_queue[(s_head + s_count) % TONE_QUEUE];
+    memcpy(seq->notes, notes, count * sizeof(ToneNote));
+    seq->count = count;
+    s_count++;
+    pthread_cond_broadcast(&s_cond);
+    pthread_mutex_unlock(&s_mutex);
+    return 0;
+}
+
+void tone_stop(void) {
+    pthread_mutex_lock(&s_mutex);
+    s_count = 0;
+    __atomic_add_fetch(&s_generation, 1, __ATOMIC_RELAXED);
+    pthread_cond_broadcast(&s_cond);
+    pthread_mutex_unlock(&s_mutex);
+}
+
+int tone_busy(void) {
+    int busy;
+    pthread_mutex_lock(&s_mutex);
+    busy = s_playing || s_count > 0;
+    pthread_mutex_unlock(&s_mutex);
+    return busy;
+}
+
+void tone_close(void) {
+    if (s_pin == -1) {
+        return;
+    }
+    pthread_mutex_lock(&s_mutex);
+    s_count = 0;
+    __atomic_store_n(&s_quit, 1, __ATOMIC_RELAXED);
+    pthread_cond_broadcast(&s_cond);
+    pthread_mutex_unlock(&s_mutex);
+
+    pthread_join(s_thread, NULL);
+    GPIOWrite(s_pin, LOW);
+    s_pin = -1;
+}
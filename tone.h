@@ -0,0 +1,35 @@
+#ifndef TONE_H
+#define TONE_H
+
+// 음 하나 (freq_hz = 0 이면 쉼표)
+typedef struct {
+    int freq_hz;
+    int duration_ms;
+} ToneNote;
+
+// 한 번에 재생 요청할 수 있는 최대 음 수, 대기시킬 수 있는 최대 요청 수
+#define TONE_NOTES_MAX 16
+#define TONE_QUEUE 4
+
+/***************************************************************************
+ * 부저 음 재생
+ * 하드웨어 PWM이 없는 핀에서도 음이 나도록 전용 스레드가 절대 시각 타이머로
+ * 반주기마다 핀을 토글함, 재생은 백그라운드에서 진행되어 호출한 쪽을 막지 않음
+ ***************************************************************************/
+
+// 핀을 출력으로 설정하고 재생 스레드 시작 (핀은 미리 export 되어 있어야 함)
+int tone_open(int pin);
+
+// 음 목록 재생 요청 (앞의 재생이 끝나면 이어서 재생), 대기열이 가득 차면 -1
+int tone_play(const ToneNote *notes, int count);
+
+// 현재 재생을 바로 멈추고 대기 중인 요청도 모두 취소
+void tone_stop(void);
+
+// 재생 중이거나 대기 중인 요청이 있으면 1
+int tone_busy(void);
+
+// 재생 스레드 종료, 핀을 LOW로 둠
+void tone_close(void);
+
+#endif
@@ -0,0 +1,114 @@
+#include <stdio.h>
+#include <time.h>
+
+#include "gpio.h"
+#include "hal.h"
+#include "ultrasonic.h"
+
+// HC-SR04 타이밍
+#define TRIG_PULSE_US 10       // TRIG 펄스 폭
+#define ECHO_START_TIMEOUT_MS 30 // TRIG 후 에코 시작까지 기다릴 최대 시간
+#define ECHO_END_TIMEOUT_MS 40   // 에코 시작 후 끝날 때까지 기다릴 최대 시간 (센서 자체 timeout 38ms)
+#define MAX_PULSE_US 23500       // 약 400cm
+#define MIN_PULSE_US 116         // 약 2cm
+#define SOUND_CM_PER_US 0.0343   // 음속: 34300 cm/s
+
+static int s_trig_pin = -1;
+static int s_line = -1;
+
+int ultrasonic_open(int trig_pin, int echo_pin) {
+    s_trig_pin = trig_pin;
+    GPIOExport(trig_pin);
+    if (GPIODirection(trig_pin, OUT) == -1 || GPIOWrite(trig_pin, LOW) == -1) {
+        return -1;
+    }
+
+    s_line = hal()->gpio_line_request(echo_pin);
+    return s_line == -1 ? -1 : 0;
+}
+
+void ultrasonic_close(void) {
+    if (s_line != -1) {
+        hal()->gpio_line_release(s_line);
+        s_line = -1;
+    }
+    if (s_trig_pin != -1) {
+        GPIOUnexport(s_trig_pin);
+        s_trig_pin = -1;
+    }
+}
+
+// 원하는 방향의 edge를 timeout_ms 안에 기다림, 1 = 수신, 0 = timeout, -1 = 오류
+static int wait_edge(int rising, HalEdge *edge, int timeout_ms) {
+    struct timespec start, now;
+    int remaining = timeout_ms;
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    while (remaining >= 0) {
+        int ret = hal()->gpio_line_read(s_line, edge, remaining);
+        if (ret <= 0) {
+            return ret;
+        }
+        if (edge->rising == rising) {
+            return 1;
+        }
+        // 반대 방향 edge는 무시하고 남은 시간만큼 다시 대기
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        remaining = timeout_ms - (int)((now.tv_sec - start.tv_sec) * 1000 +
+                                       (now.tv_nsec - start.tv_nsec) / 1000000);
+    }
+    return 0;
+}
+
+RangeResult ultrasonic_measure(void) {
+    RangeResult result = { 0.0f, 0, RANGE_ERROR };
+    struct timespec ts = { 0, TRIG_PULSE_US * 1000 };
+    HalEdge rise, fall;
+    int ret;
+
+    if (s_line == -1) {
+        return result;
+    }
+
+    // 이전 측정에서 남은 이벤트 비우기
+    while (hal()->gpio_line_read(s_line, &rise, 0) == 1) {
+    }
+
+    // TRIG 핀에 펄스 발생
+    GPIOWrite(s_trig_pin, HIGH);
+    nanosleep(&ts, NULL);
+    GPIOWrite(s_trig_pin, LOW);
+
+    ret = wait_edge(1, &rise, ECHO_START_TIMEOUT_MS);
+    if (ret <= 0) {
+        result.quality = ret == 0 ? RANGE_NO_ECHO : RANGE_ERROR;
+        return result;
+    }
+    ret = wait_edge(0, &fall, ECHO_END_TIMEOUT_MS);
+    if (ret <= 0) {
+        result.quality = ret == 0 ? RANGE_ECHO_STUCK : RANGE_ERROR;
+        return result;
+    }
+
+    // 커널 타임스탬프 차이로 펄스 폭 계산 (스케줄링 지연과 무관)
+    result.pulse_us = (long)((fall.ts_ns - rise.ts_ns) / 1000);
+    if (result.pulse_us < MIN_PULSE_US || result.pulse_us > MAX_PULSE_US) {
+        result.quality = RANGE_OUT_OF_RANGE;
+        return result;
+    }
+
+    // 거리 계산 (왕복이므로 2로 나눔)
+    result.distance_cm = result.pulse_us * SOUND_CM_PER_US / 2;
+    result.quality = RANGE_OK;
+    return result;
+}
+
+const char *range_quality_str(RangeQuality quality) {
+    switch (quality) {
+        case RANGE_OK: return "ok";
+        case RANGE_NO_ECHO: return "no echo";
+        case RANGE_ECHO_STUCK: return "echo stuck";
+        case RANGE_OUT_OF_RANGE: return "out of range";
+        default: return "error";
+    }
+}
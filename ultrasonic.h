@@ -0,0 +1,39 @@
+#ifndef ULTRASONIC_H
+#define ULTRASONIC_H
+
+// 측정 결과 품질
+typedef enum {
+    RANGE_OK = 0,        // 정상 측정
+    RANGE_NO_ECHO,       // 제한 시간 안에 에코 시작(rising)이 없음
+    RANGE_ECHO_STUCK,    // 에코가 시작됐지만 끝나지(falling) 않음
+    RANGE_OUT_OF_RANGE,  // 펄스 폭이 센서 측정 범위를 벗어남
+    RANGE_ERROR          // 장치 접근 오류
+} RangeQuality;
+
+typedef struct {
+    float distance_cm;    // 거리 (RANGE_OK 일 때만 유효)
+    long pulse_us;        // 에코 펄스 폭
+    RangeQuality quality;
+} RangeResult;
+
+/***************************************************************************
+ * ultrasonic_open(int trig_pin, int echo_pin)
+ * TRIG 핀을 출력으로 설정하고 ECHO 핀의 양쪽 edge를 라인 이벤트로 요청
+ * ECHO 핀은 sysfs로 export 하지 않아야 함
+ ***************************************************************************/
+int ultrasonic_open(int trig_pin, int echo_pin);
+
+/***************************************************************************
+ * ultrasonic_measure()
+ * TRIG 펄스를 보내고 커널이 기록한 ECHO rising/falling 시각의 차이로 거리 계산
+ * 각 edge를 기다리는 시간이 제한되어 있어 에코가 없어도 멈추지 않음
+ ***************************************************************************/
+RangeResult ultrasonic_measure(void);
+
+// 라인 이벤트 해제
+void ultrasonic_close(void);
+
+// 품질 값을 문자열로 변환
+const char *range_quality_str(RangeQuality quality);
+
+#endif
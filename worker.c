@@ -0,0 +1,81 @@
+#include <stdio.h>
+#include <time.h>
+
+#include "worker.h"
+
+static void *worker_main(void *arg) {
+    Worker *w = arg;
+    w->func(w, w->arg);
+    return NULL;
+}
+
+int worker_start(Worker *w, const char *name, WorkerFunc func, void *arg) {
+    pthread_condattr_t attr;
+
+    w->name = name;
+    w->head = 0;
+    w->count = 0;
+    w->func = func;
+    w->arg = arg;
+    pthread_mutex_init(&w->mutex, NULL);
+
+    // timeout 계산이 시스템 시간 변경에 영향받지 않도록 MONOTONIC 사용
+    pthread_condattr_init(&attr);
+    pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+    pthread_cond_init(&w->cond, &attr);
+    pthread_condattr_destroy(&attr);
+
+    if (pthread_create(&w->thread, NULL, worker_main, w) != 0) {
+        fprintf(stderr, "Failed to start %s worker\n", name);
+        return -1;
+    }
+    return 0;
+}
+
+int worker_post(Worker *w, int type, float arg0, float arg1) {
+    pthread_mutex_lock(&w->mutex);
+    if (w->count == WORKER_QUEUE) {
+        pthread_mutex_unlock(&w->mutex);
+        fprintf(stderr, "%s worker queue full, command %d dropped\n", w->name, type);
+        return -1;
+    }
+    WorkerCmd *cmd = &w->queue[(w->head + w->count) % WORKER_QUEUE];
+    cmd->type = type;
+    cmd->arg[0] = arg0;
+    cmd->arg[1] = arg1;
+    w->count++;
+    pthread_cond_signal(&w->cond);
+    pthread_mutex_unlock(&w->mutex);
+    return 0;
+}
+
+int worker_wait(Worker *w, WorkerCmd *cmd, int timeout_ms) {
+    struct timespec deadline;
+    int ret = 0;
+
+    clock_gettime(CLOCK_MONOTONIC, &deadline);
+    deadline.tv_sec += timeout_ms / 1000;
+    deadline.tv_nsec += (timeout_ms % 1000) * 1000000L;
+    if (deadline.tv_nsec >= 1000000000L) {
+        deadline.tv_sec++;
+        deadline.tv_nsec -= 1000000000L;
+    }
+
+    pthread_mutex_lock(&w->mutex);
+    while (w->count == 0) {
+        if (timeout_ms < 0) {
+            pthread_cond_wait(&w->cond, &w->mutex);
+        } else if (timeout_ms == 0 ||
+                   pthread_cond_timedwait(&w->cond, &w->mutex, &deadline) != 0) {
+            break;
+        }
+    }
+    if (w->count > 0) {
+        *cmd = w->queue[w->head];
+        w->head = (w->head + 1) % WORKER_QUEUE;
+        w->count--;
+        ret = 1;
+    }
+    pthread_mutex_unlock(&w->mutex);
+    return ret;
+}
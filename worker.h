@@ -0,0 +1,51 @@
+#ifndef WORKER_H
+#define WORKER_H
+
+#include <pthread.h>
+
+// 작업 스레드 하나가 쌓아둘 수 있는 최대 명령 수
+#define WORKER_QUEUE 8
+
+// 작업 스레드에 전달되는 명령
+typedef struct {
+    int type;      // 명령 종류 (사용하는 쪽에서 정의)
+    float arg[2];  // 명령 인자
+} WorkerCmd;
+
+typedef struct Worker Worker;
+
+// 작업 스레드 본체, worker_wait로 명령을 받아 처리하며 반환하지 않음
+typedef void (*WorkerFunc)(Worker *w, void *arg);
+
+/***************************************************************************
+ * 오래 살아있는 작업 스레드 + 명령 큐
+ * 명령이 올 때마다 스레드를 새로 만들지 않고, 시작할 때 한 번 만든 스레드에
+ * 명령을 넣어 바로 처리하게 함
+ ***************************************************************************/
+struct Worker {
+    const char *name;
+    pthread_t thread;
+    pthread_mutex_t mutex;
+    pthread_cond_t cond;
+    WorkerCmd queue[WORKER_QUEUE];
+    int head;
+    int count;
+    WorkerFunc func;
+    void *arg;
+};
+
+// 작업 스레드 시작
+int worker_start(Worker *w, const char *name, WorkerFunc func, void *arg);
+
+// 명령 추가 (큐가 가득 차면 -1)
+int worker_post(Worker *w, int type, float arg0, float arg1);
+
+/***************************************************************************
+ * worker_wait(Worker *w, WorkerCmd *cmd, int timeout_ms)
+ * 작업 스레드 안에서 다음 명령을 기다림 (timeout_ms < 0 이면 무한 대기)
+ * 1 = 명령 수신, 0 = timeout
+ * 주기적인 감시 루프의 sleep 대신 사용하면 새 명령에 바로 반응할 수 있음
+ ***************************************************************************/
+int worker_wait(Worker *w, WorkerCmd *cmd, int timeout_ms);
+
+#endif